@@ -0,0 +1,47 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "solver.hpp"
+
+struct SolverEntry {
+    std::string name;
+    std::function<std::unique_ptr<Solver>()> make;
+    // Entry whose costs are optimal for this one's movement model; it must
+    // come earlier in the registry. Empty means the first entry.
+    std::string reference = "";
+    // Preprocessing run on each map before the timed queries, if any.
+    std::function<void(GridMap &)> prepare = nullptr;
+    // Largest map side the entry runs on unless asked for by name, 0 for
+    // any; for preprocessing that would dominate the run on bigger maps.
+    int maxSize = 0;
+    // Prints notes on the entry's preprocessed data under its results,
+    // given the queries and the reference costs (nullptr without them).
+    std::function<void(const GridMap &,
+                       const std::vector<std::pair<CellId, CellId>> &,
+                       const std::vector<int> *)>
+        report = nullptr;
+    // Paths may be dearer than optimal by design. The optimality column
+    // then shows the mean cost ratio to the reference instead of a count
+    // of optimal paths.
+    bool approximate = false;
+};
+
+// Solvers available to the benchmark; the first entry is the default
+// reference used for the optimality columns.
+std::vector<SolverEntry> solverRegistry();
+
+// Runs a Moving AI .scen file through the selected solvers. The map is
+// looked up next to the scenario unless `mapPath` is given.
+int runScenarioFile(const std::string &scenPath, const std::string &mapPath,
+                    const std::vector<std::string> &solvers);
+
+// Writes generated .map/.scen fixture pairs into `dir`.
+int makeFixtures(const std::string &dir, std::uint32_t seed);
+
+#endif
@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "alt.hpp"
+#include "batch.hpp"
+#include "bench.hpp"
+#include "bidirectional.hpp"
+#include "ch_solver.hpp"
+#include "cpd_solver.hpp"
+#include "dstar_lite.hpp"
+#include "grid_map.hpp"
+#include "hpa_star.hpp"
+#include "jps.hpp"
+#include "lpa_star.hpp"
+#include "maps.hpp"
+#include "parallel_bidirectional.hpp"
+#include "solver.hpp"
+#include "theta_star.hpp"
+
+// Runs every registered solver over the generated map corpus and reports
+// throughput, work per expansion, memory growth and path optimality against
+// Dijkstra.
+//
+// Usage: pathfinding_bench [--sizes=64,256,...] [--maps=open,maze,...]
+//                          [--solvers=astar,...] [--queries=N] [--seed=N]
+//                          [--threads=N] [--json=FILE] [--no-reference]
+//                          [--ch-cache=DIR]
+//        pathfinding_bench --scen=FILE.scen [--map=FILE.map] [--solvers=...]
+//                          [--ch-cache=DIR]
+//        pathfinding_bench --make-fixtures=DIR [--seed=N]
+
+// Directory the contraction hierarchies are saved to and loaded from,
+// named by map size and terrain hash; empty builds them on every run.
+static std::string hierarchyCache;
+
+static void prepareHierarchy(GridMap &grid) {
+    if (hierarchyCache.empty()) {
+        grid.buildHierarchy();
+        return;
+    }
+    char name[64];
+    std::snprintf(
+        name, sizeof(name), "ch-%dx%d-%016llx.ch", grid.n, grid.m,
+        (unsigned long long)ContractionHierarchy::fingerprintOf(grid));
+    std::filesystem::create_directories(hierarchyCache);
+    grid.buildHierarchy(
+        (std::filesystem::path(hierarchyCache) / name).string());
+}
+
+// Memory of the landmark tables, and how close their bound and Manhattan
+// distance come to the cost of each query on average.
+static void reportLandmarks(const GridMap &grid,
+                            const std::vector<std::pair<CellId, CellId>> &qs,
+                            const std::vector<int> *reference) {
+    const Landmarks &landmarks = *grid.landmarks;
+    double bound = 0.0, manhattan = 0.0;
+    int counted = 0;
+    for (std::size_t i = 0; reference && i < qs.size(); i++) {
+        auto [start, goal] = qs[i];
+        // the reference cost includes the goal's terrain, the bounds do not
+        int cost = (*reference)[i] - grid.cost(goal);
+        if (cost <= 0) continue;
+        bound += (double)landmarks.lowerBound(start, goal) / cost;
+        manhattan += (double)(std::abs((int)grid.cellX(start) -
+                                       (int)grid.cellX(goal)) +
+                              std::abs((int)grid.cellY(start) -
+                                       (int)grid.cellY(goal))) /
+                     cost;
+        counted++;
+    }
+    std::printf("  %d landmarks, %.1f KB each", landmarks.count(),
+                landmarks.bytesPerLandmark() / 1024.0);
+    if (counted > 0)
+        std::printf(", bound %.1f%% of the cost (Manhattan %.1f%%)",
+                    100.0 * bound / counted, 100.0 * manhattan / counted);
+    std::printf("\n");
+}
+
+// Size of the path database's rows.
+static void reportPathDatabase(const GridMap &grid,
+                               const std::vector<std::pair<CellId, CellId>> &,
+                               const std::vector<int> *) {
+    const PathDatabase &db = *grid.pathDatabase;
+    std::size_t sources = std::max<std::size_t>(db.sourceCount(), 1);
+    std::printf("  %zu sources, %.1f runs and %.1f KB each\n",
+                db.sourceCount(), (double)db.runCount() / sources,
+                db.bytes() / 1024.0 / sources);
+}
+
+std::vector<SolverEntry> solverRegistry() {
+    return {
+        {"dijkstra", [] { return std::make_unique<DijkstraSolver>(); }},
+        {"dijkstra-heap",
+         [] { return std::make_unique<BasicDijkstraSolver<QuaternaryHeap>>(); }},
+        {"dijkstra-lazy",
+         [] { return std::make_unique<BasicDijkstraSolver<LazyBinaryHeap>>(); }},
+        {"astar", [] { return std::make_unique<AStarSolver>(); }},
+        {"astar-bin",
+         [] { return std::make_unique<BasicAStarSolver<BinaryHeap>>(); }},
+        {"astar-lazy",
+         [] { return std::make_unique<BasicAStarSolver<LazyBinaryHeap>>(); }},
+        {"astar-bucket",
+         [] { return std::make_unique<BasicAStarSolver<BucketQueue>>(); }},
+        {"bidir-dijkstra",
+         [] { return std::make_unique<BidirectionalDijkstraSolver>(); }},
+        {"bidir-astar",
+         [] { return std::make_unique<BidirectionalAStarSolver>(); }},
+        {"pbidir-dijkstra",
+         [] { return std::make_unique<ParallelBidirectionalDijkstraSolver>(); }},
+        {"pbidir-astar",
+         [] { return std::make_unique<ParallelBidirectionalAStarSolver>(); }},
+        {"dstar-lite", [] { return std::make_unique<DStarLiteSolver>(); }},
+        {"lpa-star", [] { return std::make_unique<LPAStarSolver>(); }},
+        {"jps", [] { return std::make_unique<JPSSolver>(); }},
+        {"jps+", [] { return std::make_unique<JPSPlusSolver>(); }, "",
+         [](GridMap &grid) { grid.buildJumpTable(); }},
+        // transitions every 8 cells of a border: near-optimal paths
+        {"hpa", [] { return std::make_unique<HPAStarSolver>(); }, "",
+         [](GridMap &grid) { grid.buildClusters(); }, 0, nullptr, true},
+        // a transition on every open border pair keeps paths optimal
+        {"hpa-exact", [] { return std::make_unique<HPAStarSolver>(); }, "",
+         [](GridMap &grid) { grid.buildClusters(16, 1); }},
+        {"ch", [] { return std::make_unique<CHSolver>(); }, "",
+         prepareHierarchy, 256},
+        {"alt", [] { return std::make_unique<ALTSolver>(); }, "",
+         [](GridMap &grid) { grid.buildLandmarks(); }, 1024, reportLandmarks},
+        {"alt-farthest", [] { return std::make_unique<ALTSolver>(); }, "",
+         [](GridMap &grid) {
+             grid.buildLandmarks(8, LandmarkStrategy::FARTHEST);
+         },
+         1024, reportLandmarks},
+        // a row for every source cell, so only small maps get one
+        {"cpd", [] { return std::make_unique<CPDSolver>(); }, "",
+         [](GridMap &grid) {
+             grid.buildPathDatabase({{0, 0, grid.n, grid.m}});
+         },
+         64, reportPathDatabase},
+        {"dijkstra-8",
+         [] {
+             return std::make_unique<
+                 BasicDijkstraSolver<BucketQueue, EightConnected>>();
+         },
+         "dijkstra-8"},
+        {"astar-8",
+         [] {
+             return std::make_unique<
+                 BasicAStarSolver<QuaternaryHeap, EightConnected>>();
+         },
+         "dijkstra-8"},
+        {"dstar-lite-8",
+         [] {
+             return std::make_unique<BasicDStarLiteSolver<EightConnected>>();
+         },
+         "dijkstra-8"},
+        {"lpa-star-8",
+         [] { return std::make_unique<BasicLPAStarSolver<EightConnected>>(); },
+         "dijkstra-8"},
+        {"dijkstra-8cut",
+         [] {
+             return std::make_unique<
+                 BasicDijkstraSolver<BucketQueue, EightConnectedCutting>>();
+         },
+         "dijkstra-8cut"},
+        {"astar-8cut",
+         [] {
+             return std::make_unique<
+                 BasicAStarSolver<QuaternaryHeap, EightConnectedCutting>>();
+         },
+         "dijkstra-8cut"},
+        // any-angle costs have no exact reference
+        {"theta", [] { return std::make_unique<ThetaStarSolver>(); }, "theta"},
+        {"lazy-theta", [] { return std::make_unique<LazyThetaStarSolver>(); },
+         "lazy-theta"},
+    };
+}
+
+static std::vector<MapSpec> mapCorpus() {
+    return {
+        {MapKind::OPEN, 0},   {MapKind::RANDOM, 10}, {MapKind::RANDOM, 20},
+        {MapKind::RANDOM, 30}, {MapKind::RANDOM, 40}, {MapKind::MAZE, 0},
+        {MapKind::ROOMS, 0},  {MapKind::TERRAIN, 0},
+    };
+}
+
+struct BenchResult {
+    std::string solver;
+    std::string map;
+    int size;
+    int queries;
+    double seconds;
+    std::size_t expansions;
+    long rssKb;  // peak growth while built and run, -1 if unmeasured
+    int found;
+    int optimal;  // -1 without a reference
+    double maxCostRatio;
+    double meanCostRatio;
+    bool approximate;
+};
+
+struct Options {
+    std::vector<int> sizes = {64, 256, 1024, 4096, 8192};
+    std::vector<std::string> maps;
+    std::vector<std::string> solvers;
+    int queries = 0;
+    // 0 runs the queries one after another on a single solver
+    int threads = 0;
+    std::uint32_t seed = 42;
+    std::string json;
+    std::string scen;
+    std::string map;
+    std::string fixtures;
+    std::string hierarchyCache;
+    bool reference = true;
+};
+
+static std::vector<std::string> split(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static bool selected(const std::vector<std::string> &filter,
+                     const std::string &name) {
+    return filter.empty() ||
+           std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const char *flag) -> const char * {
+            std::string prefix = std::string(flag) + "=";
+            if (arg.rfind(prefix, 0) != 0) return nullptr;
+            return argv[i] + prefix.size();
+        };
+        if (const char *v = value("--sizes")) {
+            options.sizes.clear();
+            for (auto &s : split(v)) options.sizes.push_back(std::stoi(s));
+        } else if (const char *v = value("--maps")) {
+            options.maps = split(v);
+        } else if (const char *v = value("--solvers")) {
+            options.solvers = split(v);
+        } else if (const char *v = value("--queries")) {
+            options.queries = std::atoi(v);
+        } else if (const char *v = value("--threads")) {
+            options.threads = std::atoi(v);
+        } else if (const char *v = value("--seed")) {
+            options.seed = std::atoi(v);
+        } else if (const char *v = value("--json")) {
+            options.json = v;
+        } else if (const char *v = value("--scen")) {
+            options.scen = v;
+        } else if (const char *v = value("--map")) {
+            options.map = v;
+        } else if (const char *v = value("--make-fixtures")) {
+            options.fixtures = v;
+        } else if (const char *v = value("--ch-cache")) {
+            options.hierarchyCache = v;
+        } else if (arg == "--no-reference") {
+            options.reference = false;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads a "kB" field such as VmRSS from /proc/self/status, -1 if missing.
+static long statusKb(const std::string &field) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind(field + ":", 0) == 0)
+            return std::atol(line.c_str() + field.size() + 1);
+    }
+    return -1;
+}
+
+// Restarts the VmHWM peak at the current RSS, so each solver's peak can
+// be told apart from the ones run before it. Linux only.
+static bool resetPeakRss() {
+    std::ofstream out("/proc/self/clear_refs");
+    out << "5";
+    out.flush();
+    return out.good();
+}
+
+// Runs the queries on `solver`, or through `batch` if it is given.
+static BenchResult runSolver(Solver &solver, BatchExecutor *batch,
+                             const SolverEntry &entry, const MapSpec &spec,
+                             const GridMap &grid,
+                             const std::vector<std::pair<CellId, CellId>> &qs,
+                             std::vector<int> &costs,
+                             const std::vector<int> *reference) {
+    BenchResult result = {entry.name, spec.name(), grid.n, (int)qs.size(),
+                          0.0,        0,           -1,     0,
+                          reference ? 0 : -1,      1.0,    1.0,
+                          entry.approximate};
+    costs.assign(qs.size(), -1);
+    auto record = [&](std::size_t i, const SearchResult &r) {
+        result.expansions += r.expansions;
+        if (r.found) {
+            costs[i] = r.cost;
+            result.found++;
+        }
+    };
+    auto begin = std::chrono::steady_clock::now();
+    if (batch) {
+        std::vector<SearchResult> rs = batch->run(grid, qs);
+        for (std::size_t i = 0; i < qs.size(); i++) record(i, rs[i]);
+    } else {
+        for (std::size_t i = 0; i < qs.size(); i++)
+            record(i, solver.findPath(grid, qs[i].first, qs[i].second));
+    }
+    result.seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    if (reference) {
+        double ratios = 0.0;
+        int compared = 0;
+        for (std::size_t i = 0; i < qs.size(); i++) {
+            int ref = (*reference)[i];
+            if (costs[i] == ref) result.optimal++;
+            if (costs[i] < 0 || ref <= 0) continue;
+            double ratio = (double)costs[i] / ref;
+            result.maxCostRatio = std::max(result.maxCostRatio, ratio);
+            ratios += ratio;
+            compared++;
+        }
+        if (compared > 0) result.meanCostRatio = ratios / compared;
+    }
+    return result;
+}
+
+static void printResult(const BenchResult &r) {
+    std::string name = r.solver + "/" + r.map + "/" + std::to_string(r.size);
+    std::string optimal = "-";
+    if (r.optimal >= 0 && r.approximate) {
+        // mean cost ratio, e.g. ~1.0123
+        char mean[16];
+        std::snprintf(mean, sizeof(mean), "~%.4f", r.meanCostRatio);
+        optimal = mean;
+    } else if (r.optimal >= 0) {
+        optimal = std::to_string(r.optimal) + "/" + std::to_string(r.queries);
+    }
+    char rss[16] = "-";
+    if (r.rssKb >= 0) std::snprintf(rss, sizeof(rss), "%.1f", r.rssKb / 1024.0);
+    std::printf("%-28s %8.1f %10.1f %12.1f %9s %10s %8.4f\n", name.c_str(),
+                r.queries / r.seconds,
+                r.expansions ? r.seconds * 1e9 / r.expansions : 0.0,
+                (double)r.expansions / r.queries, rss, optimal.c_str(),
+                r.maxCostRatio);
+    std::fflush(stdout);
+}
+
+static void writeJson(const std::string &path,
+                      const std::vector<BenchResult> &results) {
+    FILE *out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return;
+    }
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                  std::localtime(&now));
+    std::fprintf(out, "{\n  \"context\": {\n");
+    std::fprintf(out, "    \"date\": \"%s\",\n", date);
+    std::fprintf(out, "    \"num_cpus\": %u\n",
+                 std::thread::hardware_concurrency());
+    std::fprintf(out, "  },\n  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        std::fprintf(out, "    {\n");
+        std::fprintf(out, "      \"name\": \"%s/%s/%d\",\n", r.solver.c_str(),
+                     r.map.c_str(), r.size);
+        std::fprintf(out, "      \"solver\": \"%s\",\n", r.solver.c_str());
+        std::fprintf(out, "      \"map\": \"%s\",\n", r.map.c_str());
+        std::fprintf(out, "      \"size\": %d,\n", r.size);
+        std::fprintf(out, "      \"queries\": %d,\n", r.queries);
+        std::fprintf(out, "      \"real_time_s\": %.6f,\n", r.seconds);
+        std::fprintf(out, "      \"queries_per_second\": %.3f,\n",
+                     r.queries / r.seconds);
+        std::fprintf(out, "      \"expansions\": %zu,\n", r.expansions);
+        std::fprintf(out, "      \"ns_per_expansion\": %.3f,\n",
+                     r.expansions ? r.seconds * 1e9 / r.expansions : 0.0);
+        std::fprintf(out, "      \"peak_rss_growth_kb\": %ld,\n", r.rssKb);
+        std::fprintf(out, "      \"found\": %d,\n", r.found);
+        std::fprintf(out, "      \"optimal\": %d,\n", r.optimal);
+        std::fprintf(out, "      \"approximate\": %s,\n",
+                     r.approximate ? "true" : "false");
+        std::fprintf(out, "      \"mean_cost_ratio\": %.6f,\n",
+                     r.meanCostRatio);
+        std::fprintf(out, "      \"max_cost_ratio\": %.6f\n", r.maxCostRatio);
+        std::fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    std::fclose(out);
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+    hierarchyCache = options.hierarchyCache;
+    if (!options.fixtures.empty())
+        return makeFixtures(options.fixtures, options.seed);
+    if (!options.scen.empty())
+        return runScenarioFile(options.scen, options.map, options.solvers);
+
+    std::vector<SolverEntry> registry = solverRegistry();
+    std::vector<BenchResult> results;
+
+    std::printf("%-28s %8s %10s %12s %9s %10s %8s\n", "Benchmark", "q/s",
+                "ns/exp", "exp/query", "+RSS(MB)", "optimal", "max/opt");
+    for (int size : options.sizes) {
+        // fewer queries on the bigger maps
+        int queries =
+            options.queries > 0 ? options.queries : std::max(2, 16384 / size);
+        for (const MapSpec &spec : mapCorpus()) {
+            if (!selected(options.maps, spec.name())) continue;
+            GridMap grid = generateMap(spec, size, options.seed);
+            auto qs = generateQueries(grid, queries, options.seed);
+            if (qs.empty()) continue;
+
+            // costs of the reference entries needed by the selected ones
+            std::map<std::string, std::vector<int>> references;
+            std::set<std::string> needed;
+            auto referenceOf = [&](const SolverEntry &entry) {
+                return entry.reference.empty() ? registry[0].name
+                                               : entry.reference;
+            };
+            for (const SolverEntry &entry : registry) {
+                if (options.reference && selected(options.solvers, entry.name))
+                    needed.insert(referenceOf(entry));
+            }
+            std::vector<int> costs;
+            for (const SolverEntry &entry : registry) {
+                bool wanted = selected(options.solvers, entry.name);
+                bool isReference = needed.count(entry.name) > 0;
+                if (!wanted && !isReference) continue;
+                if (!isReference && entry.maxSize > 0 && size > entry.maxSize &&
+                    options.solvers.empty())
+                    continue;
+                // heap freed by earlier solvers would hide this one's growth
+#ifdef __GLIBC__
+                malloc_trim(0);
+#endif
+                long baseKb = statusKb("VmRSS");
+                bool peakReset = baseKb >= 0 && resetPeakRss();
+                std::unique_ptr<Solver> solver = entry.make();
+                std::unique_ptr<BatchExecutor> batch;
+                if (options.threads > 0)
+                    batch = std::make_unique<BatchExecutor>(entry.make,
+                                                            options.threads);
+                if (entry.prepare) entry.prepare(grid);
+                auto reference = references.find(referenceOf(entry));
+                BenchResult r = runSolver(
+                    *solver, batch.get(), entry, spec, grid, qs, costs,
+                    reference != references.end() ? &reference->second
+                                                  : nullptr);
+                if (peakReset) r.rssKb = statusKb("VmHWM") - baseKb;
+                if (isReference) references[entry.name] = costs;
+                if (!wanted) continue;
+                printResult(r);
+                if (entry.report)
+                    entry.report(grid, qs,
+                                 reference != references.end()
+                                     ? &reference->second
+                                     : nullptr);
+                results.push_back(r);
+            }
+        }
+    }
+    if (!options.json.empty()) writeJson(options.json, results);
+    return 0;
+}
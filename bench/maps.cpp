@@ -0,0 +1,175 @@
+#include "maps.hpp"
+
+#include <algorithm>
+#include <random>
+
+std::string MapSpec::name() const {
+    switch (kind) {
+        case MapKind::OPEN:
+            return "open";
+        case MapKind::RANDOM:
+            return "random" + std::to_string(density);
+        case MapKind::MAZE:
+            return "maze";
+        case MapKind::ROOMS:
+            return "rooms";
+        case MapKind::TERRAIN:
+            return "terrain";
+    }
+    return "unknown";
+}
+
+static void fillRandom(GridMap &grid, int density, std::mt19937 &rng) {
+    for (int y = 0; y < grid.m; y++) {
+        for (int x = 0; x < grid.n; x++) {
+            if ((int)(rng() % 100) < density)
+                grid.setTerrain(grid.index(x, y), CellType::WALL);
+        }
+    }
+}
+
+// Recursive backtracker over the odd coordinates, corridors one cell wide.
+static void fillMaze(GridMap &grid, std::mt19937 &rng) {
+    for (int y = 0; y < grid.m; y++) {
+        for (int x = 0; x < grid.n; x++) {
+            grid.setTerrain(grid.index(x, y), CellType::WALL);
+        }
+    }
+    const int dirs[4][2] = {{0, 2}, {0, -2}, {2, 0}, {-2, 0}};
+    std::vector<std::pair<int, int>> stack = {{1, 1}};
+    grid.setTerrain(grid.index(1, 1), CellType::CLEAR);
+    while (!stack.empty()) {
+        auto [x, y] = stack.back();
+        int order[4] = {0, 1, 2, 3};
+        std::shuffle(order, order + 4, rng);
+        bool carved = false;
+        for (int i : order) {
+            int nx = x + dirs[i][0];
+            int ny = y + dirs[i][1];
+            if (nx <= 0 || ny <= 0 || nx >= grid.n - 1 ||
+                ny >= grid.m - 1)
+                continue;
+            if (grid.passable[grid.index(nx, ny)]) continue;
+            grid.setTerrain(grid.index(x + dirs[i][0] / 2, y + dirs[i][1] / 2),
+                            CellType::CLEAR);
+            grid.setTerrain(grid.index(nx, ny), CellType::CLEAR);
+            stack.push_back({nx, ny});
+            carved = true;
+            break;
+        }
+        if (!carved) stack.pop_back();
+    }
+}
+
+// Square rooms separated by walls with a two cell wide door in most of
+// the walls.
+static void fillRooms(GridMap &grid, std::mt19937 &rng) {
+    const int room = 16;
+    for (int y = 0; y < grid.m; y++) {
+        for (int x = 0; x < grid.n; x++) {
+            if (x % room == 0 || y % room == 0)
+                grid.setTerrain(grid.index(x, y), CellType::WALL);
+        }
+    }
+    for (int ry = 0; ry < grid.m; ry += room) {
+        for (int rx = 0; rx < grid.n; rx += room) {
+            // door in the vertical wall at x = rx and the horizontal at y = ry
+            if (rx > 0 && rng() % 5 != 0) {
+                int d = ry + 1 + rng() % (room - 2);
+                for (int y = d; y < d + 2 && y < grid.m; y++)
+                    grid.setTerrain(grid.index(rx, y), CellType::CLEAR);
+            }
+            if (ry > 0 && rng() % 5 != 0) {
+                int d = rx + 1 + rng() % (room - 2);
+                for (int x = d; x < d + 2 && x < grid.n; x++)
+                    grid.setTerrain(grid.index(x, ry), CellType::CLEAR);
+            }
+        }
+    }
+}
+
+// Blobs of FOREST and WATER over a clear field with a few walls.
+static void fillTerrain(GridMap &grid, std::mt19937 &rng) {
+    int blobs = std::max(4, grid.n * grid.m / 1024);
+    int radius = std::max(3, grid.n / 32);
+    for (int i = 0; i < blobs; i++) {
+        int cx = rng() % grid.n;
+        int cy = rng() % grid.m;
+        int r = 1 + rng() % radius;
+        CellType type = rng() % 2 ? CellType::FOREST : CellType::WATER;
+        for (int y = std::max(0, cy - r); y <= std::min(grid.m - 1, cy + r);
+             y++) {
+            for (int x = std::max(0, cx - r);
+                 x <= std::min(grid.n - 1, cx + r); x++) {
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                    grid.setTerrain(grid.index(x, y), type);
+            }
+        }
+    }
+    fillRandom(grid, 5, rng);
+}
+
+GridMap generateMap(const MapSpec &spec, int size, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    GridMap grid(size, size);
+    switch (spec.kind) {
+        case MapKind::OPEN:
+            break;
+        case MapKind::RANDOM:
+            fillRandom(grid, spec.density, rng);
+            break;
+        case MapKind::MAZE:
+            fillMaze(grid, rng);
+            break;
+        case MapKind::ROOMS:
+            fillRooms(grid, rng);
+            break;
+        case MapKind::TERRAIN:
+            fillTerrain(grid, rng);
+            break;
+    }
+    return grid;
+}
+
+std::vector<std::pair<CellId, CellId>> generateQueries(const GridMap &grid,
+                                                       int count,
+                                                       std::uint32_t seed) {
+    // label the 4-connected passable regions and keep the largest one
+    std::vector<int> region(grid.size(), -1);
+    std::vector<CellId> largest;
+    std::vector<CellId> cells;
+    int regions = 0;
+    for (CellId s = 0; s < (CellId)grid.size(); s++) {
+        if (!grid.passable[s] || region[s] != -1) continue;
+        cells.clear();
+        cells.push_back(s);
+        region[s] = regions;
+        for (std::size_t i = 0; i < cells.size(); i++) {
+            int x = grid.cellX(cells[i]);
+            int y = grid.cellY(cells[i]);
+            const int dirs[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+            for (auto [dx, dy] : dirs) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m)
+                    continue;
+                CellId next = grid.index(nx, ny);
+                if (!grid.passable[next] || region[next] != -1) continue;
+                region[next] = regions;
+                cells.push_back(next);
+            }
+        }
+        if (cells.size() > largest.size()) largest = cells;
+        regions++;
+    }
+
+    std::vector<std::pair<CellId, CellId>> queries;
+    if (largest.size() < 2) return queries;
+    std::mt19937 rng(seed);
+    while ((int)queries.size() < count) {
+        CellId start = largest[rng() % largest.size()];
+        CellId goal = largest[rng() % largest.size()];
+        if (start != goal) queries.push_back({start, goal});
+    }
+    return queries;
+}
@@ -0,0 +1,29 @@
+#ifndef BENCH_MAPS_HPP
+#define BENCH_MAPS_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "grid_map.hpp"
+
+// Map families used by the benchmark corpus. Every generator is
+// deterministic for a given seed.
+enum class MapKind { OPEN, RANDOM, MAZE, ROOMS, TERRAIN };
+
+struct MapSpec {
+    MapKind kind;
+    int density;  // percentage of walls for RANDOM, ignored otherwise
+    std::string name() const;
+};
+
+GridMap generateMap(const MapSpec &spec, int size, std::uint32_t seed);
+
+// Picks `count` start/goal pairs that are both inside the largest
+// 4-connected passable region of the map.
+std::vector<std::pair<CellId, CellId>> generateQueries(const GridMap &grid,
+                                                       int count,
+                                                       std::uint32_t seed);
+
+#endif
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+#include "bench.hpp"
+#include "maps.hpp"
+#include "movingai.hpp"
+#include "scenario.hpp"
+
+// Moving AI lengths are octile without corner cutting, the movement model
+// of the entries checked against dijkstra-8.
+static bool octile(const SolverEntry &entry) {
+    return entry.reference == "dijkstra-8";
+}
+
+int runScenarioFile(const std::string &scenPath, const std::string &mapPath,
+                    const std::vector<std::string> &solvers) {
+    std::string error;
+    auto entries = loadMovingAIScenario(scenPath, error);
+    if (!entries) {
+        std::fprintf(stderr, "%s: %s\n", scenPath.c_str(), error.c_str());
+        return 1;
+    }
+    if (entries->empty()) {
+        std::fprintf(stderr, "%s: no scenarios\n", scenPath.c_str());
+        return 1;
+    }
+    std::string map = mapPath;
+    if (map.empty()) {
+        namespace fs = std::filesystem;
+        fs::path dir = fs::path(scenPath).parent_path();
+        fs::path recorded = (*entries)[0].map;
+        map = fs::exists(dir / recorded) ? (dir / recorded).string()
+                                         : (dir / recorded.filename()).string();
+    }
+    auto grid = loadMovingAIMap(map, error);
+    if (!grid) {
+        std::fprintf(stderr, "%s: %s\n", map.c_str(), error.c_str());
+        return 1;
+    }
+
+    int status = 0;
+    for (const SolverEntry &entry : solverRegistry()) {
+        if (solvers.empty() ? !octile(entry)
+                            : std::find(solvers.begin(), solvers.end(),
+                                        entry.name) == solvers.end())
+            continue;
+        if (entry.maxSize > 0 && std::max(grid->n, grid->m) > entry.maxSize &&
+            solvers.empty())
+            continue;
+        std::unique_ptr<Solver> solver = entry.make();
+        if (entry.prepare) entry.prepare(*grid);
+        ScenarioReport report = runScenario(*solver, *grid, *entries);
+        std::printf("%s on %s: %d queries, %d failed, %d mismatched, "
+                    "%d skipped, %.3f ms total\n",
+                    entry.name.c_str(), scenPath.c_str(), report.queries,
+                    report.failed, report.mismatched, report.skipped,
+                    report.seconds * 1e3);
+        std::printf("  %6s %8s %8s %10s %12s\n", "bucket", "queries",
+                    "mismatch", "us/query", "exp/query");
+        for (const BucketStats &b : report.buckets) {
+            std::printf("  %6d %8d %8d %10.2f %12.1f\n", b.bucket, b.queries,
+                        b.mismatched + b.failed, b.seconds * 1e6 / b.queries,
+                        (double)b.expansions / b.queries);
+        }
+        if (!octile(entry)) {
+            std::printf("  not 8-connected: lengths are not comparable\n");
+        } else if (report.failed || report.mismatched) {
+            status = 2;
+        }
+    }
+    return status;
+}
+
+int makeFixtures(const std::string &dir, std::uint32_t seed) {
+    namespace fs = std::filesystem;
+    fs::create_directories(dir);
+    // only CLEAR and WALL tiles, so the cheapest octile path is also the
+    // shortest, as in the Moving AI benchmarks
+    const std::pair<MapSpec, int> fixtures[] = {
+        {{MapKind::RANDOM, 20}, 256},
+        {{MapKind::MAZE, 0}, 129},
+        {{MapKind::ROOMS, 0}, 256},
+    };
+    BasicDijkstraSolver<BucketQueue, EightConnected> reference;
+    for (const auto &[spec, size] : fixtures) {
+        GridMap grid = generateMap(spec, size, seed);
+        std::string name = spec.name() + "-" + std::to_string(size);
+        std::string mapFile = name + ".map";
+        std::string mapPath = (fs::path(dir) / mapFile).string();
+        if (!saveMovingAIMap(grid, mapPath)) {
+            std::fprintf(stderr, "Cannot write %s\n", mapPath.c_str());
+            return 1;
+        }
+        std::vector<ScenarioEntry> entries;
+        for (auto [start, goal] : generateQueries(grid, 200, seed)) {
+            SearchResult r = reference.findPath(grid, start, goal);
+            double length = pathLength(grid, r.path);
+            entries.push_back({(int)std::floor(length / 4), mapFile, size,
+                               size, grid.cellX(start), grid.cellY(start),
+                               grid.cellX(goal), grid.cellY(goal),
+                               length});
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const ScenarioEntry &a, const ScenarioEntry &b) {
+                      return a.bucket < b.bucket;
+                  });
+        std::string scenFile = (fs::path(dir) / (mapFile + ".scen")).string();
+        if (!saveMovingAIScenario(entries, scenFile)) {
+            std::fprintf(stderr, "Cannot write %s\n", scenFile.c_str());
+            return 1;
+        }
+        std::printf("Wrote %s and %s\n", mapPath.c_str(), scenFile.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "alt.hpp"
+
+void ALTSolver::startSearch(const GridMap &grid, CellId start, CellId goal) {
+    target = goal;
+    landmarks = grid.landmarks.get();
+    SearchWorkspace &ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    ws.cost.set(start, 0);
+    open.push(start, 0);
+}
+
+CellId ALTSolver::expandNext(const GridMap &grid) {
+    SearchWorkspace &ws = *workspace;
+    CellId cell;
+    do {
+        if (open.empty()) return NO_CELL;
+        cell = open.pop().second;
+    } while (ws.closed.test(cell));
+    ws.closed.set(cell);
+    if (cell == target) return cell;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int cost = ws.cost[cell];
+    int leaving = grid.cost(cell);
+    forEachMove<FourConnected>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next]) return;
+        int newCost = cost + leaving * move.cost;
+        if (ws.closed.test(next) || newCost >= ws.cost[next]) return;
+        ws.cost.set(next, newCost);
+        ws.parent.set(next, cell);
+        open.push(next, newCost + calculateHeuristic(grid, next, nx, ny));
+    });
+    return cell;
+}
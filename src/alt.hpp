@@ -0,0 +1,40 @@
+#ifndef ALT_HPP
+#define ALT_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "landmarks.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// A* with landmark lower bounds (ALT) on the 4-connected grid. Manhattan
+// distance prices every cell as CLEAR, so on maps of FOREST and WATER A*
+// expands almost as much as Dijkstra; the bound of the map's landmarks
+// (see landmarks.hpp) counts the terrain in the way. The heuristic is the
+// larger of the two. Both are consistent, so paths stay optimal.
+//
+// The solver only reads the map, so call GridMap::buildLandmarks() first;
+// without landmarks it is A*.
+class ALTSolver : public Solver {
+    QuaternaryHeap open;
+    const Landmarks *landmarks = nullptr;
+
+    int calculateHeuristic(const GridMap &grid, CellId cell, int x, int y) {
+        int manhattan = std::abs(x - (int)grid.cellX(target)) +
+                        std::abs(y - (int)grid.cellY(target));
+        if (!landmarks) return manhattan;
+        return std::max(manhattan, landmarks->lowerBound(cell, target));
+    }
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+
+   public:
+    std::string getName() override { return "ALT Solver"; }
+};
+
+#endif
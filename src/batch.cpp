@@ -0,0 +1,103 @@
+#include "batch.hpp"
+
+#include <algorithm>
+
+BatchExecutor::BatchExecutor(const SolverFactory &make, unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->solver = make();
+    }
+    for (unsigned i = 1; i < threads; i++)
+        this->threads.emplace_back(&BatchExecutor::loop, this, i);
+}
+
+BatchExecutor::~BatchExecutor() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread &thread : threads) thread.join();
+}
+
+std::vector<SearchResult> BatchExecutor::run(const GridMap &grid,
+                                             std::span<const Query> queries) {
+    std::vector<SearchResult> results(queries.size());
+    if (queries.empty()) return results;
+    this->grid = &grid;
+    this->queries = queries;
+    this->results = results.data();
+    std::size_t count = workers.size();
+    for (std::size_t i = 0; i < count; i++) {
+        Worker &worker = *workers[i];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.begin = queries.size() * i / count;
+        worker.end = queries.size() * (i + 1) / count;
+    }
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        running = (unsigned)threads.size();
+        generation++;
+    }
+    wake.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return running == 0; });
+    return results;
+}
+
+bool BatchExecutor::take(Worker &worker, std::size_t &query) {
+    std::lock_guard<std::mutex> guard(worker.lock);
+    if (worker.begin == worker.end) return false;
+    query = worker.begin++;
+    return true;
+}
+
+bool BatchExecutor::steal(unsigned self, std::size_t &query) {
+    std::size_t count = workers.size();
+    for (std::size_t k = 1; k < count; k++) {
+        Worker &victim = *workers[(self + k) % count];
+        std::size_t begin, end;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.begin == victim.end) continue;
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+        // the stolen queries are out of reach of other thieves until they
+        // are published here, which only costs balance, not correctness
+        Worker &worker = *workers[self];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        query = begin;
+        worker.begin = begin + 1;
+        worker.end = end;
+        return true;
+    }
+    return false;
+}
+
+void BatchExecutor::work(unsigned self) {
+    Worker &worker = *workers[self];
+    std::size_t i;
+    while (take(worker, i) || steal(self, i)) {
+        results[i] = worker.solver->findPath(*grid, queries[i].first,
+                                             queries[i].second);
+    }
+}
+
+void BatchExecutor::loop(unsigned self) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+        }
+        work(self);
+        std::lock_guard<std::mutex> guard(mutex);
+        if (--running == 0) finished.notify_one();
+    }
+}
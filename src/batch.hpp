@@ -0,0 +1,75 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "grid_map.hpp"
+#include "solver.hpp"
+
+// Runs independent start/goal queries against one map on a pool of worker
+// threads. Every worker owns a solver made by the factory, and with it a
+// SearchWorkspace of its own, so the map is only read through findPath()
+// and may be shared by all of them.
+//
+// A batch is split into one contiguous range of queries per worker. A
+// worker takes queries from the front of its range, and once it is empty
+// steals the back half of another worker's range. Each range has its own
+// lock, which is held only to move its bounds.
+//
+// The calling thread acts as worker 0, so a pool of one thread runs the
+// queries inline. run() must not be called from two threads at once.
+class BatchExecutor {
+   public:
+    using Query = std::pair<CellId, CellId>;  // start, goal
+    using SolverFactory = std::function<std::unique_ptr<Solver>()>;
+
+    // `threads` = 0 uses one worker per hardware thread.
+    explicit BatchExecutor(const SolverFactory &make, unsigned threads = 0);
+    ~BatchExecutor();
+    BatchExecutor(const BatchExecutor &) = delete;
+    BatchExecutor &operator=(const BatchExecutor &) = delete;
+
+    // Solves every query and returns the results in input order. The map
+    // must not change until it returns.
+    std::vector<SearchResult> run(const GridMap &grid,
+                                  std::span<const Query> queries);
+    unsigned threadCount() const { return (unsigned)workers.size(); }
+
+   private:
+    struct alignas(64) Worker {
+        std::unique_ptr<Solver> solver;
+        std::mutex lock;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::uint64_t generation = 0;
+    unsigned running = 0;
+    bool quit = false;
+
+    // the batch being run
+    const GridMap *grid = nullptr;
+    std::span<const Query> queries;
+    SearchResult *results = nullptr;
+
+    bool take(Worker &worker, std::size_t &query);
+    bool steal(unsigned self, std::size_t &query);
+    void work(unsigned self);
+    void loop(unsigned self);
+};
+
+#endif
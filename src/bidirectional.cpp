@@ -0,0 +1,141 @@
+#include "bidirectional.hpp"
+
+#include <algorithm>
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicBidirectionalSolver<OpenList, Movement, ASTAR>::startSearch(
+    const GridMap &grid, CellId start, CellId goal) {
+    source = start;
+    target = goal;
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    fw.prepare(grid.size());
+    bw.prepare(grid.size());
+    forwardOpen.reset(fw);
+    backwardOpen.reset(bw);
+    fw.cost.set(start, 0);
+    bw.cost.set(goal, 0);
+    forwardOpen.push(start, potential(grid, start));
+    backwardOpen.push(goal, -potential(grid, goal));
+    done = false;
+    meet = start == goal ? start : NO_CELL;
+    best = start == goal ? 0 : INT_MAX;
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicBidirectionalSolver<OpenList, Movement, ASTAR>::expandForward(
+    const GridMap &grid, CellId cell) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int cost = fw.cost[cell];
+    int leaving = grid.cost(cell);
+    forEachMove<Movement>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next]) return;
+        if (!Movement::allowed(grid, x, y, move)) return;
+        int newCost = cost + leaving * move.cost;
+        if (fw.closed.test(next) || newCost >= fw.cost[next]) return;
+        fw.cost.set(next, newCost);
+        fw.parent.set(next, cell);
+        forwardOpen.push(next,
+                         KEY_SCALE * newCost + potential(grid, next));
+        int other = bw.cost[next];
+        if (other != INT_MAX && newCost + other < best) {
+            best = newCost + other;
+            meet = next;
+        }
+    });
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicBidirectionalSolver<OpenList, Movement, ASTAR>::expandBackward(
+    const GridMap &grid, CellId cell) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int cost = bw.cost[cell];
+    forEachMove<Movement>([&](const Move &move) {
+        // the predecessor that reaches `cell` with this move
+        int px = x - move.dx;
+        int py = y - move.dy;
+        if (px < 0 || px >= grid.n || py < 0 || py >= grid.m) return;
+        CellId prev = grid.index(px, py);
+        if (!grid.passable[prev]) return;
+        if (!Movement::allowed(grid, px, py, move)) return;
+        int newCost = cost + grid.cost(prev) * move.cost;
+        if (bw.closed.test(prev) || newCost >= bw.cost[prev]) return;
+        bw.cost.set(prev, newCost);
+        bw.parent.set(prev, cell);
+        backwardOpen.push(prev,
+                          KEY_SCALE * newCost - potential(grid, prev));
+        int other = fw.cost[prev];
+        if (other != INT_MAX && newCost + other < best) {
+            best = newCost + other;
+            meet = prev;
+        }
+    });
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+CellId BasicBidirectionalSolver<OpenList, Movement, ASTAR>::expandNext(
+    const GridMap &grid) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    // drop entries of cells that were already expanded
+    while (!forwardOpen.empty() && fw.closed.test(forwardOpen.top().second))
+        forwardOpen.pop();
+    while (!backwardOpen.empty() && bw.closed.test(backwardOpen.top().second))
+        backwardOpen.pop();
+    // with one side exhausted every path from it has been seen
+    if (forwardOpen.empty() || backwardOpen.empty()) {
+        done = meet != NO_CELL;
+        return meet;
+    }
+    long long keys = (long long)forwardOpen.top().first +
+                     backwardOpen.top().first;
+    if (keys >= (long long)KEY_SCALE * best) {
+        done = true;
+        return meet;
+    }
+
+    CellId cell;
+    if (forwardOpen.size() <= backwardOpen.size()) {
+        cell = forwardOpen.pop().second;
+        fw.closed.set(cell);
+        expandForward(grid, cell);
+    } else {
+        cell = backwardOpen.pop().second;
+        bw.closed.set(cell);
+        expandBackward(grid, cell);
+    }
+    return cell;
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+int BasicBidirectionalSolver<OpenList, Movement, ASTAR>::buildPath(
+    const GridMap &grid, CellId start, CellId goal,
+    std::vector<CellId> &path) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    path.clear();
+    for (CellId cell = meet; cell != start; cell = fw.parent[cell])
+        path.push_back(cell);
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    for (CellId cell = meet; cell != goal;) {
+        cell = bw.parent[cell];
+        path.push_back(cell);
+    }
+    return best + grid.cost(goal) * straightCost;
+}
+
+template class BasicBidirectionalSolver<QuaternaryHeap, FourConnected, true>;
+template class BasicBidirectionalSolver<BucketQueue, FourConnected, false>;
+template class BasicBidirectionalSolver<QuaternaryHeap, EightConnected, true>;
+template class BasicBidirectionalSolver<BucketQueue, EightConnected, false>;
@@ -0,0 +1,83 @@
+#ifndef BIDIRECTIONAL_HPP
+#define BIDIRECTIONAL_HPP
+
+#include <climits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "movement.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Bidirectional search: a forward search from the start and a backward
+// search from the goal, each expanding the side with the smaller open
+// list. Moves charge the cell being left, so the backward search, which
+// walks moves in reverse, charges the predecessor it steps onto instead of
+// the cell it expands. Both searches record the cheapest start-goal path
+// through any cell reached from both sides (`best`, through `meet`), and
+// the search stops once the two top keys add up to at least `best`.
+//
+// The A* variant uses the average of the two heuristics as potential,
+// p(v) = (h_goal(v) - h_start(v)) / 2, forward keys g + p and backward
+// keys g - p. The potential is consistent in both directions, which keeps
+// the same stopping rule valid; keys are doubled to stay integers.
+//
+// Once the path is known expandNext() returns the meeting cell and
+// pathFound() turns true. The backward search keeps its own workspace.
+template <typename OpenList, typename Movement, bool ASTAR>
+class BasicBidirectionalSolver : public Solver {
+    OpenList forwardOpen;
+    OpenList backwardOpen;
+    std::shared_ptr<SearchWorkspace> backward =
+        std::make_shared<SearchWorkspace>();
+    CellId source = NO_CELL;
+    CellId meet = NO_CELL;
+    int best = INT_MAX;
+    bool done = false;
+
+    static constexpr int KEY_SCALE = ASTAR ? 2 : 1;
+
+    int calculateHeuristic(const GridMap &grid, CellId from, CellId to) {
+        return Movement::heuristic(
+            std::abs((int)grid.cellX(from) - (int)grid.cellX(to)),
+            std::abs((int)grid.cellY(from) - (int)grid.cellY(to)));
+    }
+    // Twice the forward potential; the backward one is its negation.
+    int potential(const GridMap &grid, CellId cell) {
+        if (!ASTAR) return 0;
+        return calculateHeuristic(grid, cell, target) -
+               calculateHeuristic(grid, cell, source);
+    }
+    void expandForward(const GridMap &grid, CellId cell);
+    void expandBackward(const GridMap &grid, CellId cell);
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    bool pathFound(CellId) const override { return done; }
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    BasicBidirectionalSolver() { straightCost = Movement::STRAIGHT; }
+    std::string getName() override {
+        return std::string(ASTAR ? "Bidirectional A* Solver"
+                                 : "Bidirectional Dijkstra Solver") +
+               Movement::SUFFIX;
+    }
+};
+
+template <typename OpenList, typename Movement = FourConnected>
+using BasicBidirectionalAStarSolver =
+    BasicBidirectionalSolver<OpenList, Movement, true>;
+template <typename OpenList, typename Movement = FourConnected>
+using BasicBidirectionalDijkstraSolver =
+    BasicBidirectionalSolver<OpenList, Movement, false>;
+
+using BidirectionalAStarSolver = BasicBidirectionalAStarSolver<QuaternaryHeap>;
+using BidirectionalDijkstraSolver =
+    BasicBidirectionalDijkstraSolver<BucketQueue>;
+
+#endif
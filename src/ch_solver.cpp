@@ -0,0 +1,161 @@
+#include "ch_solver.hpp"
+
+#include <algorithm>
+
+using Arc = ContractionHierarchy::Arc;
+
+void CHSolver::startSearch(const GridMap &grid, CellId start, CellId goal) {
+    source = start;
+    target = goal;
+    hierarchy = nullptr;
+    bool known = grid.hierarchy == checked &&
+                 grid.terrain.sharesPages(checkedTerrain);
+    if (grid.hierarchy && (known || grid.hierarchy->matches(grid))) {
+        checked = grid.hierarchy;
+        checkedTerrain = grid.terrain;
+        hierarchy = checked.get();
+    }
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    fw.prepare(grid.size());
+    bw.prepare(grid.size());
+    forwardOpen.reset(fw);
+    backwardOpen.reset(bw);
+    fw.cost.set(start, 0);
+    bw.cost.set(goal, 0);
+    forwardOpen.push(start, 0);
+    backwardOpen.push(goal, 0);
+    done = false;
+    meet = start == goal ? start : NO_CELL;
+    best = start == goal ? 0 : INT_MAX;
+}
+
+void CHSolver::expandForward(const GridMap &grid, CellId cell) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    int cost = fw.cost[cell];
+    auto relax = [&](CellId next, int step) {
+        int newCost = cost + step;
+        if (newCost >= fw.cost[next]) return;
+        fw.cost.set(next, newCost);
+        fw.parent.set(next, cell);
+        forwardOpen.push(next, newCost);
+        int other = bw.cost[next];
+        if (other != INT_MAX && newCost + other < best) {
+            best = newCost + other;
+            meet = next;
+        }
+    };
+    if (hierarchy) {
+        // stall-on-demand: a cell reached more cheaply through a higher
+        // one is not on a shortest path up, so it is not expanded
+        bool stalled = false;
+        hierarchy->forEachDown(cell, [&](const Arc &arc) {
+            stalled |= fw.cost[arc.node] < cost - arc.cost;
+        });
+        if (stalled) return;
+        hierarchy->forEachUp(cell, [&](const Arc &arc) {
+            relax(arc.node, arc.cost);
+        });
+        return;
+    }
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    forEachMove<FourConnected>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (grid.passable[next]) relax(next, grid.cost(cell) * move.cost);
+    });
+}
+
+void CHSolver::expandBackward(const GridMap &grid, CellId cell) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    int cost = bw.cost[cell];
+    auto relax = [&](CellId prev, int step) {
+        int newCost = cost + step;
+        if (newCost >= bw.cost[prev]) return;
+        bw.cost.set(prev, newCost);
+        bw.parent.set(prev, cell);
+        backwardOpen.push(prev, newCost);
+        int other = fw.cost[prev];
+        if (other != INT_MAX && newCost + other < best) {
+            best = newCost + other;
+            meet = prev;
+        }
+    };
+    if (hierarchy) {
+        bool stalled = false;
+        hierarchy->forEachUp(cell, [&](const Arc &arc) {
+            stalled |= bw.cost[arc.node] < cost - arc.cost;
+        });
+        if (stalled) return;
+        hierarchy->forEachDown(cell, [&](const Arc &arc) {
+            relax(arc.node, arc.cost);
+        });
+        return;
+    }
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    forEachMove<FourConnected>([&](const Move &move) {
+        // the predecessor that reaches `cell` with this move
+        int px = x - move.dx;
+        int py = y - move.dy;
+        if (px < 0 || px >= grid.n || py < 0 || py >= grid.m) return;
+        CellId prev = grid.index(px, py);
+        if (grid.passable[prev]) relax(prev, grid.cost(prev) * move.cost);
+    });
+}
+
+CellId CHSolver::expandNext(const GridMap &grid) {
+    // a side is finished once nothing it holds can improve on `best`
+    bool forward = !forwardOpen.empty() && forwardOpen.top().first < best;
+    bool backward = !backwardOpen.empty() && backwardOpen.top().first < best;
+    // without a hierarchy the searches also meet the usual way: no path
+    // through the two open lists is shorter than the sum of their tops
+    if (forward && backward && !hierarchy &&
+        forwardOpen.top().first + backwardOpen.top().first >= best)
+        forward = backward = false;
+    if (!forward && !backward) {
+        done = meet != NO_CELL;
+        return meet;
+    }
+    if (forward && backward)
+        forward = forwardOpen.top().first <= backwardOpen.top().first;
+    CellId cell;
+    if (forward) {
+        cell = forwardOpen.pop().second;
+        expandForward(grid, cell);
+    } else {
+        cell = backwardOpen.pop().second;
+        expandBackward(grid, cell);
+    }
+    return cell;
+}
+
+int CHSolver::buildPath(const GridMap &grid, CellId start, CellId goal,
+                        std::vector<CellId> &path) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    // the nodes the two searches went through, start to goal
+    std::vector<CellId> nodes;
+    for (CellId cell = meet; cell != start; cell = fw.parent[cell])
+        nodes.push_back(cell);
+    nodes.push_back(start);
+    std::reverse(nodes.begin(), nodes.end());
+    for (CellId cell = meet; cell != goal;) {
+        cell = bw.parent[cell];
+        nodes.push_back(cell);
+    }
+    path.assign(1, start);
+    for (std::size_t i = 1; i < nodes.size(); i++) {
+        if (hierarchy) {
+            hierarchy->unpack(nodes[i - 1], nodes[i], path);
+        } else {
+            path.push_back(nodes[i]);
+        }
+    }
+    return best + grid.cost(goal) * straightCost;
+}
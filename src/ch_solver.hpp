@@ -0,0 +1,57 @@
+#ifndef CH_SOLVER_HPP
+#define CH_SOLVER_HPP
+
+#include <climits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "contraction_hierarchy.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Exact queries on a contraction hierarchy (see contraction_hierarchy.hpp):
+// a forward search from the start and a backward search from the goal
+// that both only climb to nodes of higher rank. Every shortest path has a
+// highest node, which both searches reach with exact costs, so the best
+// meeting cell seen is the answer once neither open list holds a key
+// below it. Cells that the other direction's arcs reach more cheaply are
+// stalled, not expanded. The path is then unpacked into moves.
+//
+// The solver only reads the map, so call GridMap::buildHierarchy() first,
+// or its overload taking a file to load from or save to. Without a hierarchy, every move counts as climbing
+// and the search is a plain bidirectional Dijkstra. The backward search
+// keeps its own workspace.
+class CHSolver : public Solver {
+    QuaternaryHeap forwardOpen;
+    QuaternaryHeap backwardOpen;
+    std::shared_ptr<SearchWorkspace> backward =
+        std::make_shared<SearchWorkspace>();
+    // The map's hierarchy for the current query, null without one.
+    const ContractionHierarchy *hierarchy = nullptr;
+    // The last hierarchy found to match its map, and that map's terrain.
+    // Checking hashes the whole terrain, so it is skipped while the map
+    // still shares every terrain page with the one checked.
+    std::shared_ptr<const ContractionHierarchy> checked;
+    PagedArray<CellType> checkedTerrain;
+    CellId source = NO_CELL;
+    CellId meet = NO_CELL;
+    int best = INT_MAX;
+    bool done = false;
+
+    void expandForward(const GridMap &grid, CellId cell);
+    void expandBackward(const GridMap &grid, CellId cell);
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    bool pathFound(CellId) const override { return done; }
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    std::string getName() override { return "Contraction Hierarchy Solver"; }
+};
+
+#endif
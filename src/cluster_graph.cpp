@@ -0,0 +1,198 @@
+#include "cluster_graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include "grid_map.hpp"
+#include "movement.hpp"
+
+int ClusterGraph::clusterOf(const GridMap &grid, CellId cell) const {
+    return (grid.cellY(cell) / side) * columns + grid.cellX(cell) / side;
+}
+
+int ClusterGraph::nodeIndex(int c, CellId cell) const {
+    const std::vector<CellId> &nodes = clusters[c]->nodes;
+    auto it = std::lower_bound(nodes.begin(), nodes.end(), cell);
+    if (it == nodes.end() || *it != cell) return -1;
+    return it - nodes.begin();
+}
+
+void ClusterGraph::bounds(const GridMap &grid, int c, int &x0, int &y0,
+                          int &x1, int &y1) const {
+    x0 = c % columns * side;
+    y0 = c / columns * side;
+    x1 = std::min(x0 + side, grid.n);
+    y1 = std::min(y0 + side, grid.m);
+}
+
+// Leaving cost of every cell of cluster c, 0 for walls, indexed like the
+// output of distances().
+void ClusterGraph::loadCosts(const GridMap &grid, int c,
+                             std::vector<int> &costs) const {
+    int x0, y0, x1, y1;
+    bounds(grid, c, x0, y0, x1, y1);
+    costs.assign(side * side, 0);
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            CellId cell = grid.index(x, y);
+            if (grid.passable[cell])
+                costs[(y - y0) * side + (x - x0)] = grid.cost(cell);
+        }
+    }
+}
+
+// Dijkstra over the cells of one cluster, see distances(). Moves cost at
+// most the largest terrain cost, so the open cells fit in a ring of that
+// many buckets (Dial's algorithm); `buckets` is scratch space for it.
+void ClusterGraph::sweep(const std::vector<int> &costs, int from,
+                         bool reverse, std::vector<int> &out,
+                         std::vector<std::vector<int>> &buckets) const {
+    int ring = *std::max_element(costs.begin(), costs.end()) + 1;
+    if ((int)buckets.size() < ring) buckets.resize(ring);
+    out.assign(side * side, INF);
+    out[from] = 0;
+    buckets[0].push_back(from);
+    std::size_t queued = 1;
+    for (int cost = 0; queued > 0; cost++) {
+        std::vector<int> &bucket = buckets[cost % ring];
+        // relaxing with a positive cost never adds to the current bucket
+        for (int cell : bucket) {
+            queued--;
+            if (cost > out[cell]) continue;
+            int x = cell % side;
+            auto relax = [&](int next) {
+                if (costs[next] == 0) return;
+                // searching backwards, the move goes from `next` to `cell`
+                int newCost = cost + costs[reverse ? next : cell];
+                if (newCost >= out[next]) return;
+                out[next] = newCost;
+                buckets[newCost % ring].push_back(next);
+                queued++;
+            };
+            if (x > 0) relax(cell - 1);
+            if (x + 1 < side) relax(cell + 1);
+            if (cell >= side) relax(cell - side);
+            if (cell + side < side * side) relax(cell + side);
+        }
+        bucket.clear();
+    }
+}
+
+void ClusterGraph::distances(const GridMap &grid, CellId from, bool reverse,
+                             std::vector<int> &out, std::vector<int> &costs,
+                             std::vector<std::vector<int>> &buckets) const {
+    int c = clusterOf(grid, from);
+    int x0, y0, x1, y1;
+    bounds(grid, c, x0, y0, x1, y1);
+    loadCosts(grid, c, costs);
+    sweep(costs,
+          (grid.cellY(from) - y0) * side + (grid.cellX(from) - x0), reverse,
+          out, buckets);
+}
+
+// Adds the transitions on the border of cluster (cx, cy) towards the
+// neighbour in direction `dir` (see FourConnected::moves). Both clusters
+// see the same runs, so they agree on where the transitions are.
+void ClusterGraph::addTransitions(const GridMap &grid, int cx, int cy,
+                                  int dir, std::vector<CellId> &nodes) const {
+    const Move &move = FourConnected::moves[dir];
+    if (cx + move.dx < 0 || cx + move.dx >= columns || cy + move.dy < 0 ||
+        cy + move.dy >= rows)
+        return;
+    int x0, y0, x1, y1;
+    bounds(grid, cy * columns + cx, x0, y0, x1, y1);
+    int fixed = move.dx > 0   ? x1 - 1
+                : move.dx < 0 ? x0
+                : move.dy > 0 ? y1 - 1
+                              : y0;
+    auto cell = [&](int t) {
+        return move.dx ? grid.index(fixed, t) : grid.index(t, fixed);
+    };
+    auto open = [&](int t) {
+        int x = move.dx ? fixed : t;
+        int y = move.dx ? t : fixed;
+        return grid.passable[grid.index(x, y)] &&
+               grid.passable[grid.index(x + move.dx, y + move.dy)];
+    };
+    int end = move.dx ? y1 : x1;
+    for (int t = move.dx ? y0 : x0; t < end;) {
+        if (!open(t)) {
+            t++;
+            continue;
+        }
+        int first = t;
+        while (t < end && open(t)) t++;
+        int last = t - 1;
+        if (last - first + 1 <= spacing) {
+            nodes.push_back(cell((first + last) / 2));
+            continue;
+        }
+        for (int p = first; p < last; p += spacing) nodes.push_back(cell(p));
+        nodes.push_back(cell(last));
+    }
+}
+
+std::shared_ptr<const ClusterGraph::Cluster> ClusterGraph::buildCluster(
+    const GridMap &grid, int cx, int cy) const {
+    auto cluster = std::make_shared<Cluster>();
+    std::vector<CellId> &nodes = cluster->nodes;
+    for (int dir = 0; dir < 4; dir++) addTransitions(grid, cx, cy, dir, nodes);
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    int x0, y0, x1, y1;
+    bounds(grid, cy * columns + cx, x0, y0, x1, y1);
+    std::size_t k = nodes.size();
+    std::vector<int> offsets;
+    for (CellId node : nodes)
+        offsets.push_back((grid.cellY(node) - y0) * side +
+                          (grid.cellX(node) - x0));
+    std::vector<int> costs, out;
+    std::vector<std::vector<int>> buckets;
+    loadCosts(grid, cy * columns + cx, costs);
+    cluster->dist.resize(k * k);
+    for (std::size_t i = 0; i < k; i++) {
+        sweep(costs, offsets[i], false, out, buckets);
+        for (std::size_t j = 0; j < k; j++)
+            cluster->dist[i * k + j] = out[offsets[j]];
+    }
+    return cluster;
+}
+
+void ClusterGraph::build(const GridMap &grid, int size, int spacing) {
+    side = size;
+    this->spacing = spacing;
+    columns = (grid.n + size - 1) / size;
+    rows = (grid.m + size - 1) / size;
+    clusters.assign(columns * rows, nullptr);
+    // clusters are independent, so rows of them are built in parallel
+    std::atomic<int> next{0};
+    auto work = [&] {
+        for (int cy; (cy = next++) < rows;) {
+            for (int cx = 0; cx < columns; cx++)
+                clusters[cy * columns + cx] = buildCluster(grid, cx, cy);
+        }
+    };
+    std::vector<std::thread> threads;
+    unsigned count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < count && i < (unsigned)rows; i++)
+        threads.emplace_back(work);
+    work();
+    for (std::thread &thread : threads) thread.join();
+}
+
+void ClusterGraph::update(const GridMap &grid, int x, int y) {
+    int cx = x / side;
+    int cy = y / side;
+    auto rebuild = [&](int cx, int cy) {
+        clusters[cy * columns + cx] = buildCluster(grid, cx, cy);
+    };
+    rebuild(cx, cy);
+    // the transitions of a border depend on the cells on both sides of it
+    if (x % side == 0 && cx > 0) rebuild(cx - 1, cy);
+    if ((x + 1) % side == 0 && cx + 1 < columns) rebuild(cx + 1, cy);
+    if (y % side == 0 && cy > 0) rebuild(cx, cy - 1);
+    if ((y + 1) % side == 0 && cy + 1 < rows) rebuild(cx, cy + 1);
+}
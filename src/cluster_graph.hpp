@@ -0,0 +1,84 @@
+#ifndef CLUSTER_GRAPH_HPP
+#define CLUSTER_GRAPH_HPP
+
+#include <climits>
+#include <memory>
+#include <vector>
+
+#include "utils.hpp"
+
+struct GridMap;
+
+// Abstract graph for HPA* (see hpa_star.hpp) on the 4-connected grid. The
+// map is cut into square clusters of `size` cells a side. Where two
+// neighbouring clusters share a run of open cell pairs across their
+// border, the run gets transitions: its middle if it is at most `spacing`
+// long, otherwise both ends and every `spacing`-th pair in between. Both
+// cells of a transition become nodes of their clusters, and every cluster
+// stores the cheapest in-cluster cost between each pair of its nodes.
+//
+// With spacing 1 every open border pair is a transition and the abstract
+// graph keeps every optimal path; larger spacings and clusters make it
+// smaller, so queries get faster and paths slightly longer.
+//
+// Clusters are immutable and shared between copies of the graph, so
+// copying a map only copies the cluster table. The graph is built on
+// demand and then kept up to date by GridMap::setTerrain, which rebuilds
+// the cluster of the changed cell and the neighbours whose border it
+// lies on.
+class ClusterGraph {
+   public:
+    static constexpr int INF = INT_MAX / 4;
+
+    struct Cluster {
+        // Node cells, sorted.
+        std::vector<CellId> nodes;
+        // dist[i * nodes.size() + j]: cost from node i to node j, INF if
+        // j cannot be reached inside the cluster.
+        std::vector<int> dist;
+    };
+
+   private:
+    std::vector<std::shared_ptr<const Cluster>> clusters;
+    int side = 0;
+    int spacing = 0;
+    int columns = 0;
+    int rows = 0;
+
+    void loadCosts(const GridMap &grid, int c, std::vector<int> &costs) const;
+    void sweep(const std::vector<int> &costs, int from, bool reverse,
+               std::vector<int> &out,
+               std::vector<std::vector<int>> &buckets) const;
+    void addTransitions(const GridMap &grid, int cx, int cy, int dir,
+                        std::vector<CellId> &nodes) const;
+    std::shared_ptr<const Cluster> buildCluster(const GridMap &grid, int cx,
+                                                int cy) const;
+
+   public:
+    bool built() const { return !clusters.empty(); }
+    int clusterSize() const { return side; }
+    int nodeSpacing() const { return spacing; }
+
+    int clusterOf(const GridMap &grid, CellId cell) const;
+    const Cluster &cluster(int c) const { return *clusters[c]; }
+    // Index of `cell` in cluster c's nodes, -1 if it is not a node.
+    int nodeIndex(int c, CellId cell) const;
+    // Cell range [x0, x1) x [y0, y1) of cluster c.
+    void bounds(const GridMap &grid, int c, int &x0, int &y0, int &x1,
+                int &y1) const;
+    // Cheapest in-cluster costs from `from` to every cell of its cluster,
+    // or with `reverse` from every cell to `from`. `out` is indexed by the
+    // offset (y - y0) * clusterSize() + (x - x0) and holds INF for cells
+    // that cannot be reached. `costs` and `buckets` are scratch space, so
+    // a caller that keeps them across calls does not allocate.
+    void distances(const GridMap &grid, CellId from, bool reverse,
+                   std::vector<int> &out, std::vector<int> &costs,
+                   std::vector<std::vector<int>> &buckets) const;
+
+    // Builds the clusters on all hardware threads.
+    void build(const GridMap &grid, int size, int spacing);
+    // Updates the graph after the terrain of (x, y) changed.
+    void update(const GridMap &grid, int x, int y);
+};
+
+#endif
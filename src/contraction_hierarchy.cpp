@@ -0,0 +1,408 @@
+#include "contraction_hierarchy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "epoch.hpp"
+#include "grid_map.hpp"
+#include "movement.hpp"
+
+namespace {
+
+using Arc = ContractionHierarchy::Arc;
+constexpr int INF = ContractionHierarchy::INF;
+
+// Witness searches give up after this many settled nodes and add the
+// shortcut instead, which is never wrong, only larger.
+constexpr int WITNESS_LIMIT = 500;
+
+enum NodeState : std::uint8_t { REMAINING, IN_ROUND, CONTRACTED };
+
+// Scratch space of one thread's witness searches.
+struct Witness {
+    EpochArray<int> dist;
+    std::vector<std::pair<int, CellId>> heap;
+};
+
+// Calls f(i, witness) for i in [0, count) on all hardware threads.
+template <typename F>
+void parallelFor(std::vector<Witness> &witnesses, std::size_t count, F f) {
+    std::atomic<std::size_t> next{0};
+    auto work = [&](Witness &witness) {
+        for (std::size_t i; (i = next++) < count;) f(i, witness);
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < witnesses.size(); t++)
+        threads.emplace_back(work, std::ref(witnesses[t]));
+    work(witnesses[0]);
+    for (std::thread &thread : threads) thread.join();
+}
+
+class Contractor {
+    std::size_t count;
+    std::vector<std::vector<Arc>> out;
+    std::vector<std::vector<Arc>> in;
+    std::vector<NodeState> state;
+    std::vector<int> priority;
+    std::vector<int> contractedNeighbours;
+    std::vector<Witness> witnesses;
+
+    // Cheapest cost from `from` to every node settled before the limit,
+    // avoiding `skip` and every node that is not REMAINING. Stops early
+    // once the heads of all the `targets` are settled.
+    void witnessSearch(Witness &w, CellId from, CellId skip, int limit,
+                       const std::vector<Arc> &targets) {
+        w.dist.prepare(count, INF);
+        w.heap.clear();
+        w.dist.set(from, 0);
+        w.heap.push_back({0, from});
+        std::greater<std::pair<int, CellId>> later;
+        std::size_t unsettled = targets.size();
+        for (int settled = 0; !w.heap.empty() && settled < WITNESS_LIMIT;) {
+            std::pop_heap(w.heap.begin(), w.heap.end(), later);
+            auto [cost, node] = w.heap.back();
+            w.heap.pop_back();
+            if (cost > w.dist[node]) continue;
+            if (cost > limit) break;
+            settled++;
+            for (const Arc &target : targets) unsettled -= target.node == node;
+            if (unsettled == 0) break;
+            for (const Arc &arc : out[node]) {
+                if (arc.node == skip || state[arc.node] != REMAINING) continue;
+                int newCost = cost + arc.cost;
+                if (newCost >= w.dist[arc.node]) continue;
+                w.dist.set(arc.node, newCost);
+                w.heap.push_back({newCost, arc.node});
+                std::push_heap(w.heap.begin(), w.heap.end(), later);
+            }
+        }
+    }
+
+    // The shortcuts contracting v needs, as (tail, arc) pairs.
+    void findShortcuts(CellId v, Witness &w,
+                       std::vector<std::pair<CellId, Arc>> &shortcuts) {
+        shortcuts.clear();
+        int longest = 0;
+        for (const Arc &arc : out[v]) longest = std::max(longest, arc.cost);
+        for (const Arc &first : in[v]) {
+            witnessSearch(w, first.node, v, first.cost + longest, out[v]);
+            for (const Arc &second : out[v]) {
+                if (second.node == first.node) continue;
+                int cost = first.cost + second.cost;
+                if (w.dist[second.node] > cost)
+                    shortcuts.push_back({first.node, {second.node, cost, v}});
+            }
+        }
+    }
+
+    // The shortcut count in the priority is estimated without witness
+    // searches: a pair u -> v -> x counts unless an arc u -> x replaces
+    // it. Ranking by the exact count was slower and gave no fewer
+    // shortcuts on grids.
+    int computePriority(CellId v) const {
+        int shortcuts = 0;
+        for (const Arc &first : in[v]) {
+            for (const Arc &second : out[v]) {
+                if (second.node == first.node) continue;
+                int cost = first.cost + second.cost;
+                bool replaced = false;
+                for (const Arc &arc : out[first.node])
+                    replaced |= arc.node == second.node && arc.cost <= cost;
+                shortcuts += !replaced;
+            }
+        }
+        return shortcuts - (int)(in[v].size() + out[v].size()) +
+               2 * contractedNeighbours[v];
+    }
+
+    // Ties are broken by a hash of the id, so that a round picks nodes
+    // spread over the map rather than along a sweep line.
+    bool before(CellId a, CellId b) const {
+        if (priority[a] != priority[b]) return priority[a] < priority[b];
+        return a * 2654435761u < b * 2654435761u;
+    }
+
+    bool lowestAround(CellId v) const {
+        for (const Arc &arc : out[v]) {
+            if (!before(v, arc.node)) return false;
+        }
+        for (const Arc &arc : in[v]) {
+            if (!before(v, arc.node)) return false;
+        }
+        return true;
+    }
+
+    static void erase(std::vector<Arc> &arcs, CellId node) {
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                                  [&](const Arc &a) { return a.node == node; }),
+                   arcs.end());
+    }
+
+    void addShortcut(CellId from, const Arc &arc) {
+        for (Arc &existing : out[from]) {
+            if (existing.node != arc.node) continue;
+            if (arc.cost >= existing.cost) return;
+            existing = arc;
+            for (Arc &back : in[arc.node]) {
+                if (back.node == from) back = {from, arc.cost, arc.middle};
+            }
+            return;
+        }
+        out[from].push_back(arc);
+        in[arc.node].push_back({from, arc.cost, arc.middle});
+    }
+
+   public:
+    std::vector<std::uint32_t> rank;
+    std::vector<std::vector<Arc>> up;
+    std::vector<std::vector<Arc>> down;
+
+    explicit Contractor(const GridMap &grid)
+        : count(grid.size()),
+          out(count),
+          in(count),
+          state(count, REMAINING),
+          priority(count),
+          contractedNeighbours(count),
+          witnesses(std::max(1u, std::thread::hardware_concurrency())),
+          rank(count),
+          up(count),
+          down(count) {
+        for (int y = 0; y < grid.m; y++) {
+            for (int x = 0; x < grid.n; x++) {
+                CellId cell = grid.index(x, y);
+                if (!grid.passable[cell]) continue;
+                forEachMove<FourConnected>([&](const Move &move) {
+                    int nx = x + move.dx;
+                    int ny = y + move.dy;
+                    if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m)
+                        return;
+                    CellId next = grid.index(nx, ny);
+                    if (!grid.passable[next]) return;
+                    int cost = grid.cost(cell) * move.cost;
+                    out[cell].push_back({next, cost, NO_CELL});
+                    in[next].push_back({cell, cost, NO_CELL});
+                });
+            }
+        }
+    }
+
+    void run() {
+        parallelFor(witnesses, count, [&](std::size_t v, Witness &) {
+            priority[v] = computePriority(v);
+        });
+        std::vector<CellId> remaining(count);
+        for (std::size_t v = 0; v < count; v++) remaining[v] = v;
+        std::uint32_t next = 0;
+        std::vector<CellId> round;
+        std::vector<std::vector<std::pair<CellId, Arc>>> shortcuts;
+        std::vector<CellId> touched;
+        while (!remaining.empty()) {
+            round.clear();
+            for (CellId v : remaining) {
+                if (lowestAround(v)) round.push_back(v);
+            }
+            for (CellId v : round) state[v] = IN_ROUND;
+            shortcuts.resize(round.size());
+            parallelFor(witnesses, round.size(),
+                        [&](std::size_t i, Witness &w) {
+                            findShortcuts(round[i], w, shortcuts[i]);
+                        });
+
+            touched.clear();
+            for (std::size_t i = 0; i < round.size(); i++) {
+                CellId v = round[i];
+                rank[v] = next++;
+                up[v] = std::move(out[v]);
+                down[v] = std::move(in[v]);
+                for (const Arc &arc : up[v]) {
+                    erase(in[arc.node], v);
+                    touched.push_back(arc.node);
+                }
+                for (const Arc &arc : down[v]) {
+                    erase(out[arc.node], v);
+                    touched.push_back(arc.node);
+                }
+                for (auto &[from, arc] : shortcuts[i]) addShortcut(from, arc);
+                state[v] = CONTRACTED;
+            }
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()),
+                          touched.end());
+            for (CellId node : touched) contractedNeighbours[node]++;
+            parallelFor(witnesses, touched.size(),
+                        [&](std::size_t i, Witness &) {
+                            priority[touched[i]] = computePriority(touched[i]);
+                        });
+            auto contracted = [&](CellId v) {
+                return state[v] == CONTRACTED;
+            };
+            remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                           contracted),
+                            remaining.end());
+        }
+    }
+};
+
+std::uint64_t terrainFingerprint(const GridMap &grid) {
+    // FNV-1a over the terrain costs
+    std::uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < grid.size(); i++) {
+        hash ^= (std::uint64_t)grid.cost(i);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void flatten(const std::vector<std::vector<Arc>> &lists,
+             std::vector<std::uint32_t> &first, std::vector<Arc> &arcs) {
+    first.assign(1, 0);
+    arcs.clear();
+    for (const std::vector<Arc> &list : lists) {
+        arcs.insert(arcs.end(), list.begin(), list.end());
+        first.push_back(arcs.size());
+    }
+}
+
+constexpr char MAGIC[4] = {'P', 'F', 'C', 'H'};
+constexpr std::uint32_t FORMAT = 1;
+
+template <typename T>
+void writeVector(std::ofstream &out, const std::vector<T> &values) {
+    std::uint64_t size = values.size();
+    out.write((const char *)&size, sizeof(size));
+    out.write((const char *)values.data(), size * sizeof(T));
+}
+
+// `bytes` bounds the size read, so a corrupt file cannot ask for more
+// memory than it could fill.
+template <typename T>
+bool readVector(std::ifstream &in, std::vector<T> &values,
+                std::uint64_t bytes) {
+    std::uint64_t size = 0;
+    if (!in.read((char *)&size, sizeof(size)) || size > bytes / sizeof(T))
+        return false;
+    values.resize(size);
+    return (bool)in.read((char *)values.data(), size * sizeof(T));
+}
+
+}  // namespace
+
+ContractionHierarchy ContractionHierarchy::build(const GridMap &grid) {
+    Contractor contractor(grid);
+    contractor.run();
+    ContractionHierarchy ch;
+    ch.n = grid.n;
+    ch.m = grid.m;
+    ch.fingerprint = terrainFingerprint(grid);
+    ch.rank = std::move(contractor.rank);
+    flatten(contractor.up, ch.firstUp, ch.up);
+    flatten(contractor.down, ch.firstDown, ch.down);
+    return ch;
+}
+
+bool ContractionHierarchy::save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write((const char *)&FORMAT, sizeof(FORMAT));
+    out.write((const char *)&n, sizeof(n));
+    out.write((const char *)&m, sizeof(m));
+    out.write((const char *)&fingerprint, sizeof(fingerprint));
+    writeVector(out, rank);
+    writeVector(out, firstUp);
+    writeVector(out, up);
+    writeVector(out, firstDown);
+    writeVector(out, down);
+    return (bool)out;
+}
+
+std::optional<ContractionHierarchy> ContractionHierarchy::load(
+    const std::string &path, const GridMap &grid, std::string &error) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    std::uint64_t bytes = in.tellg();
+    in.seekg(0);
+    char magic[4];
+    std::uint32_t format = 0;
+    ContractionHierarchy ch;
+    in.read(magic, sizeof(magic));
+    in.read((char *)&format, sizeof(format));
+    if (!in || !std::equal(magic, magic + 4, MAGIC) || format != FORMAT) {
+        error = path + " is not a contraction hierarchy";
+        return std::nullopt;
+    }
+    in.read((char *)&ch.n, sizeof(ch.n));
+    in.read((char *)&ch.m, sizeof(ch.m));
+    in.read((char *)&ch.fingerprint, sizeof(ch.fingerprint));
+    if (!in || ch.n != grid.n || ch.m != grid.m ||
+        ch.fingerprint != terrainFingerprint(grid)) {
+        error = path + " was built for another map";
+        return std::nullopt;
+    }
+    std::uint64_t cells = grid.size();
+    if (!readVector(in, ch.rank, bytes) || !readVector(in, ch.firstUp, bytes) ||
+        !readVector(in, ch.up, bytes) || !readVector(in, ch.firstDown, bytes) ||
+        !readVector(in, ch.down, bytes) || ch.rank.size() != cells ||
+        ch.firstUp.size() != cells + 1 || ch.firstDown.size() != cells + 1 ||
+        ch.firstUp.back() != ch.up.size() ||
+        ch.firstDown.back() != ch.down.size()) {
+        error = path + " is truncated or corrupt";
+        return std::nullopt;
+    }
+    return ch;
+}
+
+std::uint64_t ContractionHierarchy::fingerprintOf(const GridMap &grid) {
+    return terrainFingerprint(grid);
+}
+
+bool ContractionHierarchy::matches(const GridMap &grid) const {
+    return n == grid.n && m == grid.m &&
+           fingerprint == terrainFingerprint(grid);
+}
+
+std::size_t ContractionHierarchy::shortcuts() const {
+    std::size_t result = 0;
+    for (const Arc &arc : up) result += arc.middle != NO_CELL;
+    for (const Arc &arc : down) result += arc.middle != NO_CELL;
+    return result;
+}
+
+const ContractionHierarchy::Arc *ContractionHierarchy::findArc(
+    CellId from, CellId to) const {
+    if (rank[from] < rank[to]) {
+        for (std::uint32_t i = firstUp[from]; i < firstUp[from + 1]; i++) {
+            if (up[i].node == to) return &up[i];
+        }
+    } else {
+        for (std::uint32_t i = firstDown[to]; i < firstDown[to + 1]; i++) {
+            if (down[i].node == from) return &down[i];
+        }
+    }
+    return nullptr;
+}
+
+void ContractionHierarchy::unpack(CellId from, CellId to,
+                                  std::vector<CellId> &path) const {
+    std::vector<std::pair<CellId, CellId>> stack = {{from, to}};
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        const Arc *arc = findArc(a, b);
+        if (arc->middle == NO_CELL) {
+            path.push_back(b);
+            continue;
+        }
+        // the first half goes on top, so it is unpacked first
+        stack.push_back({arc->middle, b});
+        stack.push_back({a, arc->middle});
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include <climits>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "utils.hpp"
+
+struct GridMap;
+
+// Contraction hierarchy of the 4-connected grid graph, for exact queries
+// on maps that do not change (see ch_solver.hpp). Every cell is a node;
+// a move from u to a neighbour costs u's terrain cost. Nodes are
+// contracted one by one in order of rank: contracting v removes it and
+// adds a shortcut u -> x for every path u -> v -> x that no other path
+// of at most its cost (a witness) replaces. A shortcut remembers v, so
+// it can be unpacked into the two arcs it stands for.
+//
+// Each node keeps the arcs to nodes of higher rank (`up`) and the arcs
+// from nodes of higher rank (`down`, stored at the arc's head), which is
+// all the bidirectional query needs.
+//
+// Contraction runs in rounds on all hardware threads. A round contracts a
+// set of nodes no two of which are neighbours, each ranked below all of
+// its neighbours by the priority
+//
+//   shortcuts added - arcs removed + 2 * contracted neighbours,
+//
+// with the shortcuts estimated from the arcs already present. The witness
+// searches avoid every node of the round, so the round's contractions do
+// not depend on each other.
+class ContractionHierarchy {
+   public:
+    static constexpr int INF = INT_MAX / 4;
+
+    struct Arc {
+        CellId node;
+        int cost;
+        // The contracted node a shortcut skips, NO_CELL for a move.
+        CellId middle;
+    };
+
+   private:
+    int n = 0;
+    int m = 0;
+    std::uint64_t fingerprint = 0;
+    std::vector<std::uint32_t> rank;
+    std::vector<std::uint32_t> firstUp;
+    std::vector<Arc> up;
+    std::vector<std::uint32_t> firstDown;
+    std::vector<Arc> down;
+
+    const Arc *findArc(CellId from, CellId to) const;
+
+   public:
+    static ContractionHierarchy build(const GridMap &grid);
+    // Files are raw arrays in the machine's byte order, tagged with the
+    // map's dimensions and a hash of its terrain. load() reads one saved
+    // for `grid`; it fails if the file is not a hierarchy or was made for
+    // a map of other dimensions or terrain.
+    static std::optional<ContractionHierarchy> load(const std::string &path,
+                                                    const GridMap &grid,
+                                                    std::string &error);
+    bool save(const std::string &path) const;
+    // The terrain hash files are tagged with.
+    static std::uint64_t fingerprintOf(const GridMap &grid);
+
+    // Whether the hierarchy was built for a map with the dimensions and
+    // terrain of `grid`. Hashes the whole terrain.
+    bool matches(const GridMap &grid) const;
+    std::size_t shortcuts() const;
+
+    // Calls f(arc) for every arc from `cell` to a node of higher rank.
+    template <typename F>
+    void forEachUp(CellId cell, F f) const {
+        for (std::uint32_t i = firstUp[cell]; i < firstUp[cell + 1]; i++)
+            f(up[i]);
+    }
+    // Calls f(arc) for every arc into `cell` from a node of higher rank;
+    // arc.node is the tail.
+    template <typename F>
+    void forEachDown(CellId cell, F f) const {
+        for (std::uint32_t i = firstDown[cell]; i < firstDown[cell + 1]; i++)
+            f(down[i]);
+    }
+
+    // Appends the cells after `from` along the arc from `from` to `to`,
+    // replacing shortcuts by the moves they stand for.
+    void unpack(CellId from, CellId to, std::vector<CellId> &path) const;
+};
+
+#endif
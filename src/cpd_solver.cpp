@@ -0,0 +1,28 @@
+#include "cpd_solver.hpp"
+
+void CPDSolver::startSearch(const GridMap &grid, CellId start, CellId goal) {
+    const PathDatabase *database = grid.pathDatabase.get();
+    lookedUp = database && database->covers(grid, start);
+    if (!lookedUp) {
+        AStarSolver::startSearch(grid, start, goal);
+        return;
+    }
+    target = goal;
+    reachable = database->findPath(grid, start, goal, found);
+}
+
+CellId CPDSolver::expandNext(const GridMap &grid) {
+    if (!lookedUp) return AStarSolver::expandNext(grid);
+    return reachable ? target : NO_CELL;
+}
+
+int CPDSolver::buildPath(const GridMap &grid, CellId start, CellId goal,
+                         std::vector<CellId> &path) {
+    if (!lookedUp) return AStarSolver::buildPath(grid, start, goal, path);
+    path = found;
+    // 4-connected: every cell on the path is left by a straight move, the
+    // goal included
+    int cost = 0;
+    for (CellId cell : path) cost += grid.cost(cell) * straightCost;
+    return cost;
+}
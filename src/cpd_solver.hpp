@@ -0,0 +1,32 @@
+#ifndef CPD_SOLVER_HPP
+#define CPD_SOLVER_HPP
+
+#include <string>
+#include <vector>
+
+#include "path_database.hpp"
+#include "solver.hpp"
+
+// Answers queries from the map's path database (see path_database.hpp)
+// with table lookups and no search; such a query counts one expansion, the
+// goal. Queries whose start has no row, and all of them on a map without
+// a database, are searched with A*. The solver only reads the map, so call
+// GridMap::buildPathDatabase() first.
+class CPDSolver : public AStarSolver {
+    // Whether the current query is answered from the database.
+    bool lookedUp = false;
+    bool reachable = false;
+    std::vector<CellId> found;
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    std::string getName() override { return "CPD Solver"; }
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "dstar_lite.hpp"
+
+#include <algorithm>
+
+template <typename Movement>
+auto BasicDStarLiteSolver<Movement>::key(const GridMap &grid, CellId cell)
+    -> Key {
+    int cost = std::min(g(cell), rhs[cell]);
+    if (cost >= INF) return {INF, INF};
+    return {cost + calculateHeuristic(grid, source, cell) + km, cost};
+}
+
+// Cheapest way to the goal through one move from `cell`, INF if there is
+// none. `best` receives the cell that move reaches.
+template <typename Movement>
+int BasicDStarLiteSolver<Movement>::lookahead(const GridMap &grid,
+                                              CellId cell, CellId *best) {
+    int result = INF;
+    if (!grid.passable[cell]) return result;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int leaving = grid.cost(cell);
+    forEachMove<Movement>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next] || g(next) >= INF) return;
+        if (!Movement::allowed(grid, x, y, move)) return;
+        int cost = leaving * move.cost + g(next);
+        if (cost < result) {
+            result = cost;
+            if (best) *best = next;
+        }
+    });
+    return result;
+}
+
+template <typename Movement>
+void BasicDStarLiteSolver<Movement>::updateVertex(const GridMap &grid,
+                                                  CellId cell) {
+    if (cell != target) rhs.set(cell, lookahead(grid, cell));
+    if (g(cell) != rhs[cell]) {
+        open.update(cell, key(grid, cell));
+    } else {
+        open.remove(cell);
+    }
+}
+
+// Updates every cell that can move onto `cell`.
+template <typename Movement>
+void BasicDStarLiteSolver<Movement>::updatePredecessors(const GridMap &grid,
+                                                        CellId cell) {
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    forEachMove<Movement>([&](const Move &move) {
+        int px = x - move.dx;
+        int py = y - move.dy;
+        if (px < 0 || px >= grid.n || py < 0 || py >= grid.m) return;
+        updateVertex(grid, grid.index(px, py));
+    });
+}
+
+template <typename Movement>
+bool BasicDStarLiteSolver<Movement>::consistent(const GridMap &grid) {
+    if (g(source) != rhs[source]) return false;
+    return open.empty() || open.top().first >= key(grid, source);
+}
+
+template <typename Movement>
+void BasicDStarLiteSolver<Movement>::startSearch(const GridMap &grid,
+                                                 CellId start, CellId goal) {
+    SearchWorkspace &ws = *workspace;
+    open.reset(ws);
+    done = false;
+    expanded = 0;
+    if (!planned || goal != target || planned->n != grid.n ||
+        planned->m != grid.m) {
+        target = goal;
+        source = start;
+        km = 0;
+        ws.prepare(grid.size());
+        rhs.prepare(grid.size(), INF);
+        rhs.set(goal, 0);
+        open.push(goal, key(grid, goal));
+        planned = grid;
+        return;
+    }
+    km += calculateHeuristic(grid, source, start);
+    source = start;
+    if (forEachChangedNeighbourhood(
+            *planned, grid, [&](CellId cell) { updateVertex(grid, cell); }))
+        planned = grid;
+}
+
+template <typename Movement>
+CellId BasicDStarLiteSolver<Movement>::expandNext(const GridMap &grid) {
+    SearchWorkspace &ws = *workspace;
+    if (consistent(grid)) {
+        done = g(source) < INF;
+        return done ? source : NO_CELL;
+    }
+    auto [old, cell] = open.top();
+    Key current = key(grid, cell);
+    // queued before the start moved
+    if (old < current) {
+        open.update(cell, current);
+        return cell;
+    }
+    expanded++;
+    if (g(cell) > rhs[cell]) {
+        ws.cost.set(cell, rhs[cell]);
+        open.remove(cell);
+    } else {
+        ws.cost.set(cell, INF);
+        updateVertex(grid, cell);
+    }
+    updatePredecessors(grid, cell);
+    return cell;
+}
+
+// Follows the cheapest move from the start on; the g values along it are
+// exact once the start is consistent.
+template <typename Movement>
+int BasicDStarLiteSolver<Movement>::buildPath(const GridMap &grid,
+                                              CellId start, CellId goal,
+                                              std::vector<CellId> &path) {
+    path.clear();
+    CellId cell = start;
+    path.push_back(cell);
+    while (cell != goal && path.size() <= (std::size_t)grid.size()) {
+        lookahead(grid, cell, &cell);
+        path.push_back(cell);
+    }
+    return g(start) + grid.cost(goal) * straightCost;
+}
+
+template class BasicDStarLiteSolver<FourConnected>;
+template class BasicDStarLiteSolver<EightConnected>;
@@ -0,0 +1,80 @@
+#ifndef DSTAR_LITE_HPP
+#define DSTAR_LITE_HPP
+
+#include <climits>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "grid_map.hpp"
+#include "movement.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// D* Lite: a search from the goal towards the start that is repaired
+// instead of repeated when the map changes or the start moves along the
+// path. Every cell keeps g, its cost to the goal, and rhs, the one-step
+// lookahead min over moves (cost of the move + g of the cell reached).
+// Cells where the two differ are queued with key
+//
+//   [min(g, rhs) + h(start, cell) + km, min(g, rhs)]
+//
+// compared lexicographically, and the search stops once the start is
+// consistent and no queued key is below its own. The second part matters:
+// a cell tied with the start on the first one may still lower the start's
+// cost. km collects h(old start, new start) over start moves, so
+// the queued keys stay valid lower bounds without re-keying the queue.
+//
+// The solver keeps a copy of the map of its last query. A query with the
+// same goal compares the new map with that copy (see
+// forEachChangedNeighbourhood in grid_map.hpp) and only re-evaluates the
+// cells around the changed ones; a different goal or map size starts afresh. The
+// search state stays in the workspace between queries, so it must not be
+// shared with other solvers.
+template <typename Movement = FourConnected>
+class BasicDStarLiteSolver : public Solver {
+    static constexpr int INF = INT_MAX / 4;
+    using Key = std::pair<int, int>;
+
+    IndexedHeap<4, Key> open;
+    EpochArray<int> rhs;
+    std::optional<GridMap> planned;
+    CellId source = NO_CELL;
+    int km = 0;
+    bool done = false;
+
+    int calculateHeuristic(const GridMap &grid, CellId from, CellId to) {
+        return Movement::heuristic(
+            std::abs((int)grid.cellX(from) - (int)grid.cellX(to)),
+            std::abs((int)grid.cellY(from) - (int)grid.cellY(to)));
+    }
+    int g(CellId cell) const { return std::min(workspace->cost[cell], INF); }
+    Key key(const GridMap &grid, CellId cell);
+    int lookahead(const GridMap &grid, CellId cell, CellId *best = nullptr);
+    void updateVertex(const GridMap &grid, CellId cell);
+    void updatePredecessors(const GridMap &grid, CellId cell);
+    bool consistent(const GridMap &grid);
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start, CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    bool pathFound(CellId) const override { return done; }
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    // Cells expanded by the last query, re-expansions included. A repair
+    // after a small change expands only the cells whose cost changed.
+    std::size_t expanded = 0;
+
+    BasicDStarLiteSolver() { straightCost = Movement::STRAIGHT; }
+    std::string getName() override {
+        return std::string("D* Lite Solver") + Movement::SUFFIX;
+    }
+};
+
+using DStarLiteSolver = BasicDStarLiteSolver<>;
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-cell storage that can be logically cleared in O(1). Every slot carries
+// the epoch it was last written in; slots from an older epoch read as the
+// fallback value. Starting a new query only bumps the epoch, the arrays are
+// touched again only when the epoch counter wraps around.
+
+// Packed bitset (one bit per cell, stamped per 64-bit word).
+class EpochBitset {
+    std::vector<std::uint64_t> words;
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t epoch = 1;
+    std::size_t bits = 0;
+
+   public:
+    // Sizes the set for `count` bits and starts a new, empty epoch.
+    void prepare(std::size_t count) {
+        if (count != bits) {
+            bits = count;
+            words.assign((count + 63) / 64, 0);
+            stamps.assign(words.size(), 0);
+            epoch = 1;
+            return;
+        }
+        clear();
+    }
+
+    void clear() {
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool test(std::size_t i) const {
+        std::size_t w = i >> 6;
+        return stamps[w] == epoch && (words[w] >> (i & 63)) & 1;
+    }
+
+    void set(std::size_t i) {
+        std::size_t w = i >> 6;
+        if (stamps[w] != epoch) {
+            stamps[w] = epoch;
+            words[w] = 0;
+        }
+        words[w] |= std::uint64_t(1) << (i & 63);
+    }
+
+    void reset(std::size_t i) {
+        std::size_t w = i >> 6;
+        if (stamps[w] == epoch) words[w] &= ~(std::uint64_t(1) << (i & 63));
+    }
+
+    std::size_t size() const { return bits; }
+};
+
+template <typename T>
+class EpochArray {
+    std::vector<T> values;
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t epoch = 1;
+    T fallback{};
+
+   public:
+    // Sizes the array for `count` slots that all read as `empty` until
+    // written, starting a new epoch.
+    void prepare(std::size_t count, T empty) {
+        fallback = empty;
+        if (count != values.size()) {
+            values.assign(count, empty);
+            stamps.assign(count, 0);
+            epoch = 1;
+            return;
+        }
+        clear();
+    }
+
+    void clear() {
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool contains(std::size_t i) const { return stamps[i] == epoch; }
+    T operator[](std::size_t i) const {
+        return stamps[i] == epoch ? values[i] : fallback;
+    }
+    void set(std::size_t i, T value) {
+        stamps[i] = epoch;
+        values[i] = value;
+    }
+
+    std::size_t size() const { return values.size(); }
+};
+
+#endif
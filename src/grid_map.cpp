@@ -0,0 +1,64 @@
+#include "grid_map.hpp"
+
+GridMap::GridMap(int n, int m) {
+    this->n = n;
+    this->m = m;
+    terrain.assign(size(), CellType::CLEAR);
+    passable.assign(size(), 1);
+}
+
+void GridMap::setTerrain(CellId id, CellType type) {
+    if (terrain[id] == type) return;
+    // lower bounds stay valid, and consistent, while costs only grow
+    if (landmarks && type < terrain[id]) landmarks.reset();
+    terrain.edit(id) = type;
+    passable.edit(id) = type != CellType::WALL;
+    if (jumps.built()) jumps.update(*this, cellX(id), cellY(id));
+    if (clusters.built()) clusters.update(*this, cellX(id), cellY(id));
+    hierarchy.reset();
+    pathDatabase.reset();
+}
+
+void GridMap::buildJumpTable() {
+    if (!jumps.built()) jumps.build(*this);
+}
+
+void GridMap::buildClusters(int size, int spacing) {
+    if (clusters.built() && clusters.clusterSize() == size &&
+        clusters.nodeSpacing() == spacing)
+        return;
+    clusters.build(*this, size, spacing);
+}
+
+void GridMap::buildHierarchy() {
+    if (!hierarchy)
+        hierarchy = std::make_shared<const ContractionHierarchy>(
+            ContractionHierarchy::build(*this));
+}
+
+bool GridMap::buildHierarchy(const std::string &path) {
+    if (hierarchy) return false;
+    std::string error;
+    if (auto loaded = ContractionHierarchy::load(path, *this, error)) {
+        hierarchy =
+            std::make_shared<const ContractionHierarchy>(std::move(*loaded));
+        return true;
+    }
+    buildHierarchy();
+    hierarchy->save(path);
+    return false;
+}
+
+void GridMap::buildLandmarks(int count, LandmarkStrategy strategy) {
+    if (landmarks && landmarks->count() == count &&
+        landmarks->strategy() == strategy)
+        return;
+    landmarks = std::make_shared<const Landmarks>(
+        Landmarks::build(*this, count, strategy));
+}
+
+void GridMap::buildPathDatabase(
+    const std::vector<PathDatabase::Region> &regions) {
+    pathDatabase = std::make_shared<const PathDatabase>(
+        PathDatabase::build(*this, regions));
+}
@@ -0,0 +1,98 @@
+#ifndef GRID_MAP_HPP
+#define GRID_MAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cluster_graph.hpp"
+#include "contraction_hierarchy.hpp"
+#include "jump_table.hpp"
+#include "landmarks.hpp"
+#include "paged_array.hpp"
+#include "path_database.hpp"
+#include "utils.hpp"
+
+// The static part of a map: its terrain, stored row-major as separate
+// arrays indexed by CellId, so a neighbour lookup is a single offset
+// instead of a row pointer chase. Search state lives elsewhere (see
+// SearchState and SearchWorkspace), so once built a map can be shared as
+// a `shared_ptr<const GridMap>` by any number of solvers and threads.
+// The arrays are paged (see paged_array.hpp): a copy shares the storage
+// of the original until either is edited, which is how MapStore publishes
+// new versions of a map.
+// The JPS+ jump table and the HPA* cluster graph are empty until
+// buildJumpTable() and buildClusters() are called, and are then updated on
+// every terrain change. The contraction hierarchy, the ALT landmarks and
+// the path database are only built by buildHierarchy() (or loaded),
+// buildLandmarks() and buildPathDatabase(), and are shared by copies of
+// the map. An edit drops the hierarchy and the path database; landmarks
+// are kept while cells only get dearer (see Landmarks).
+struct GridMap {
+    int n;
+    int m;
+    PagedArray<CellType> terrain;
+    PagedArray<std::uint8_t> passable;
+    JumpTable jumps;
+    ClusterGraph clusters;
+    std::shared_ptr<const ContractionHierarchy> hierarchy;
+    std::shared_ptr<const Landmarks> landmarks;
+    std::shared_ptr<const PathDatabase> pathDatabase;
+    // Set by MapStore::publish(), 0 for maps that were never published.
+    std::uint64_t version = 0;
+
+    GridMap(int n, int m);
+
+    int size() const { return n * m; }
+    CellId index(unsigned int x, unsigned int y) const { return y * n + x; }
+    unsigned int cellX(CellId id) const { return id % n; }
+    unsigned int cellY(CellId id) const { return id / n; }
+    int cost(CellId id) const { return static_cast<int>(terrain[id]); }
+    CellType type(CellId id) const { return terrain[id]; }
+
+    void setTerrain(CellId id, CellType type);
+    void buildJumpTable();
+    // Builds the cluster graph, unless it is already built with the same
+    // parameters (see ClusterGraph).
+    void buildClusters(int size = 32, int spacing = 8);
+    void buildHierarchy();
+    // Like buildHierarchy(), but first tries the hierarchy saved at `path`
+    // and saves the one it builds there if that was not made for this map.
+    // Returns whether it was loaded.
+    bool buildHierarchy(const std::string &path);
+    // Builds the landmarks, unless they are already built with the same
+    // parameters.
+    void buildLandmarks(int count = 8,
+                        LandmarkStrategy strategy = LandmarkStrategy::AVOID);
+    // Builds a path database with rows for the cells of `regions`,
+    // replacing any previous one.
+    void buildPathDatabase(const std::vector<PathDatabase::Region> &regions);
+};
+
+// Calls f(cell) for every cell of the 3x3 blocks around the cells whose
+// terrain differs between `older` and `grid`, two versions of a map of the
+// same size; a cell in several blocks is passed once per block. Moves into
+// and out of a changed cell, and diagonals passing it, all start and end
+// in its block, so these are the cells the incremental solvers (see
+// dstar_lite.hpp) re-evaluate. Returns whether any cell changed.
+template <typename F>
+bool forEachChangedNeighbourhood(const GridMap &older, const GridMap &grid,
+                                 F f) {
+    bool changed = false;
+    older.terrain.forEachDifference(grid.terrain, [&](std::size_t cell) {
+        changed = true;
+        int x = grid.cellX(cell);
+        int y = grid.cellY(cell);
+        for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, grid.m - 1);
+             ny++) {
+            for (int nx = std::max(x - 1, 0);
+                 nx <= std::min(x + 1, grid.n - 1); nx++)
+                f(grid.index(nx, ny));
+        }
+    });
+    return changed;
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include "hpa_star.hpp"
+
+#include <algorithm>
+
+#include "cluster_graph.hpp"
+
+void HPAStarSolver::startSearch(const GridMap &grid, CellId start,
+                                CellId goal) {
+    target = goal;
+    source = start;
+    SearchWorkspace &ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    ws.cost.set(start, 0);
+    open.push(start, {0, 0});
+    startLinks.clear();
+    goalLinks.clear();
+    goalCluster = -1;
+    const ClusterGraph &graph = grid.clusters;
+    if (!graph.built()) return;
+
+    int side = graph.clusterSize();
+    int x0, y0, x1, y1;
+    auto offset = [&](CellId cell) {
+        return (grid.cellY(cell) - y0) * side + (grid.cellX(cell) - x0);
+    };
+    int startCluster = graph.clusterOf(grid, start);
+    goalCluster = graph.clusterOf(grid, goal);
+    graph.distances(grid, start, false, distances, clusterCosts, buckets);
+    graph.bounds(grid, startCluster, x0, y0, x1, y1);
+    for (CellId node : graph.cluster(startCluster).nodes) {
+        int cost = distances[offset(node)];
+        if (cost < ClusterGraph::INF) startLinks.push_back({node, cost});
+    }
+    if (goalCluster == startCluster &&
+        distances[offset(goal)] < ClusterGraph::INF)
+        startLinks.push_back({goal, distances[offset(goal)]});
+    graph.distances(grid, goal, true, distances, clusterCosts, buckets);
+    graph.bounds(grid, goalCluster, x0, y0, x1, y1);
+    for (CellId node : graph.cluster(goalCluster).nodes)
+        goalLinks.push_back(distances[offset(node)]);
+}
+
+void HPAStarSolver::relax(const GridMap &grid, CellId from, CellId to,
+                          int cost) {
+    SearchWorkspace &ws = *workspace;
+    if (ws.closed.test(to) || cost >= ws.cost[to]) return;
+    ws.cost.set(to, cost);
+    ws.parent.set(to, from);
+    open.push(to, {cost + calculateHeuristic(grid, to), -cost});
+}
+
+CellId HPAStarSolver::expandNext(const GridMap &grid) {
+    SearchWorkspace &ws = *workspace;
+    CellId cell;
+    do {
+        if (open.empty()) return NO_CELL;
+        cell = open.pop().second;
+    } while (ws.closed.test(cell));
+    ws.closed.set(cell);
+    if (cell == target) return cell;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int cost = ws.cost[cell];
+    int leaving = grid.cost(cell);
+    const ClusterGraph &graph = grid.clusters;
+    if (!graph.built()) {
+        forEachMove<FourConnected>([&](const Move &move) {
+            int nx = x + move.dx;
+            int ny = y + move.dy;
+            if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+            CellId next = grid.index(nx, ny);
+            if (grid.passable[next])
+                relax(grid, cell, next, cost + leaving * move.cost);
+        });
+        return cell;
+    }
+
+    if (cell == source) {
+        for (auto [node, link] : startLinks)
+            relax(grid, cell, node, cost + link);
+    }
+    int c = graph.clusterOf(grid, cell);
+    int i = graph.nodeIndex(c, cell);
+    if (i < 0) return cell;
+    const ClusterGraph::Cluster &cluster = graph.cluster(c);
+    std::size_t k = cluster.nodes.size();
+    for (std::size_t j = 0; j < k; j++) {
+        int edge = cluster.dist[i * k + j];
+        if (edge < ClusterGraph::INF)
+            relax(grid, cell, cluster.nodes[j], cost + edge);
+    }
+    if (c == goalCluster && goalLinks[i] < ClusterGraph::INF)
+        relax(grid, cell, target, cost + goalLinks[i]);
+    // steps across the border onto a node of the neighbouring cluster
+    forEachMove<FourConnected>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next]) return;
+        int other = graph.clusterOf(grid, next);
+        if (other != c && graph.nodeIndex(other, next) >= 0)
+            relax(grid, cell, next, cost + leaving * move.cost);
+    });
+    return cell;
+}
+
+// Appends the cells after `from` up to `to`, two cells of one cluster,
+// found by an A* that stays inside the cluster.
+void HPAStarSolver::refine(const GridMap &grid, CellId from, CellId to,
+                           std::vector<CellId> &path) {
+    // a single step is never beaten by a detour
+    if (std::abs((int)grid.cellX(from) - (int)grid.cellX(to)) +
+            std::abs((int)grid.cellY(from) - (int)grid.cellY(to)) ==
+        1) {
+        path.push_back(to);
+        return;
+    }
+    const ClusterGraph &graph = grid.clusters;
+    int x0, y0, x1, y1;
+    graph.bounds(grid, graph.clusterOf(grid, from), x0, y0, x1, y1);
+    SearchWorkspace &ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    target = to;
+    ws.cost.set(from, 0);
+    open.push(from, {0, 0});
+    while (!open.empty()) {
+        CellId cell = open.pop().second;
+        if (ws.closed.test(cell)) continue;
+        ws.closed.set(cell);
+        if (cell == to) break;
+        int x = grid.cellX(cell);
+        int y = grid.cellY(cell);
+        int cost = ws.cost[cell] + grid.cost(cell);
+        forEachMove<FourConnected>([&](const Move &move) {
+            int nx = x + move.dx;
+            int ny = y + move.dy;
+            if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1) return;
+            CellId next = grid.index(nx, ny);
+            if (grid.passable[next]) relax(grid, cell, next, cost);
+        });
+    }
+    std::size_t end = path.size();
+    for (CellId cell = to; cell != from; cell = ws.parent[cell])
+        path.push_back(cell);
+    std::reverse(path.begin() + end, path.end());
+}
+
+int HPAStarSolver::buildPath(const GridMap &grid, CellId start, CellId goal,
+                             std::vector<CellId> &path) {
+    SearchWorkspace &ws = *workspace;
+    int cost = ws.cost[goal];
+    // the refinement reuses the workspace, so take the nodes out first
+    std::vector<CellId> nodes;
+    for (CellId cell = goal; cell != start; cell = ws.parent[cell])
+        nodes.push_back(cell);
+    nodes.push_back(start);
+    std::reverse(nodes.begin(), nodes.end());
+    path.assign(1, start);
+    for (std::size_t i = 1; i < nodes.size(); i++)
+        refine(grid, nodes[i - 1], nodes[i], path);
+    target = goal;
+    return cost + grid.cost(goal) * straightCost;
+}
@@ -0,0 +1,62 @@
+#ifndef HPA_STAR_HPP
+#define HPA_STAR_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Hierarchical Path-Finding A* on the 4-connected grid. The search runs
+// on the map's cluster graph (see cluster_graph.hpp): the start and the
+// goal are linked to the nodes of their clusters by a search inside
+// those, and A* then moves from node to node. The abstract path is
+// refined by an A* inside one cluster per intra-cluster edge, so only the
+// clusters on the path are ever searched cell by cell. Expansions count
+// abstract nodes.
+//
+// Paths are optimal on the abstract graph, not on the grid: they can only
+// cross a cluster border at its transition nodes, so with the default
+// node spacing of 8 the solver is approximate. On the bench maps paths
+// cost 0-2% more than optimal on average and at worst about 1.25 times as
+// much. With a node spacing of 1 every open border pair is a transition
+// and paths are optimal, at several times the expansions. The solver only
+// reads the map, so call GridMap::buildClusters() first; without a graph
+// it searches the grid itself, like A*.
+class HPAStarSolver : public Solver {
+    // f, then -g: among equal f the deepest node goes first, which on the
+    // long straight edges of the abstract graph avoids expanding every
+    // tied detour
+    IndexedHeap<4, std::pair<int, int>> open;
+    CellId source = NO_CELL;
+    // Links of the start to the nodes of its cluster, and the costs from
+    // each node of the goal's cluster to the goal.
+    std::vector<std::pair<CellId, int>> startLinks;
+    std::vector<int> goalLinks;
+    int goalCluster = -1;
+    // ClusterGraph::distances() output and scratch, kept between queries
+    std::vector<int> distances;
+    std::vector<int> clusterCosts;
+    std::vector<std::vector<int>> buckets;
+
+    int calculateHeuristic(const GridMap &grid, CellId cell) {
+        return std::abs((int)grid.cellX(cell) - (int)grid.cellX(target)) +
+               std::abs((int)grid.cellY(cell) - (int)grid.cellY(target));
+    }
+    void relax(const GridMap &grid, CellId from, CellId to, int cost);
+    void refine(const GridMap &grid, CellId from, CellId to,
+                std::vector<CellId> &path);
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    std::string getName() override { return "HPA* Solver"; }
+};
+
+#endif
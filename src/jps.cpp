@@ -0,0 +1,191 @@
+#include "jps.hpp"
+
+#include <algorithm>
+
+// True if (x, y) is outside the grid, a wall, or costs `cost`.
+static bool sameCost(const GridMap &grid, int x, int y, int cost) {
+    return JumpTable::blocked(grid, x, y) ||
+           grid.cost(grid.index(x, y)) == cost;
+}
+
+// Steps from (x, y) along dx and returns the first jump point, or NO_CELL
+// if the scan runs into a wall. `cost` is increased by the cost of every
+// cell left on the way.
+CellId JPSSolver::jumpHorizontal(const GridMap &grid, int x, int y, int dx,
+                                 int &cost) const {
+    // the origin may be non-uniform, so the first cell gets a full check;
+    // after that only the column entering the 3x3 window is new
+    bool first = true;
+    while (true) {
+        int leaving = grid.cost(grid.index(x, y));
+        cost += leaving;
+        x += dx;
+        if (JumpTable::blocked(grid, x, y)) return NO_CELL;
+        CellId id = grid.index(x, y);
+        if (id == target) return id;
+        if (first ? !JumpTable::uniform(grid, x, y)
+                  : !(sameCost(grid, x + dx, y - 1, leaving) &&
+                      sameCost(grid, x + dx, y, leaving) &&
+                      sameCost(grid, x + dx, y + 1, leaving)))
+            return id;
+        first = false;
+        if (JumpTable::forced(grid, x, y, dx)) return id;
+    }
+}
+
+// Steps from (x, y) along dy. A cell of the run is a jump point if a
+// horizontal scan from it finds one.
+CellId JPSSolver::jumpVertical(const GridMap &grid, int x, int y, int dy,
+                               int &cost) const {
+    bool first = true;
+    while (true) {
+        int leaving = grid.cost(grid.index(x, y));
+        cost += leaving;
+        y += dy;
+        if (JumpTable::blocked(grid, x, y)) return NO_CELL;
+        CellId id = grid.index(x, y);
+        if (id == target) return id;
+        if (first ? !JumpTable::uniform(grid, x, y)
+                  : !(sameCost(grid, x - 1, y + dy, leaving) &&
+                      sameCost(grid, x, y + dy, leaving) &&
+                      sameCost(grid, x + 1, y + dy, leaving)))
+            return id;
+        first = false;
+        for (int sx : {-1, 1}) {
+            int scanCost = 0;
+            if (jumpHorizontal(grid, x, y, sx, scanCost) != NO_CELL)
+                return id;
+        }
+    }
+}
+
+// Looks the jump up in the jump table. The goal is not in the table: the
+// jump stops at it when it lies on the scanned line, and a vertical jump
+// also stops on the goal's row when the goal can be reached horizontally
+// from there. All cells passed over are uniform, so the cost is that of
+// the first one times the number of steps.
+CellId JPSSolver::jumpPrecomputed(const GridMap &grid, int x, int y,
+                                  int dx, int dy, int &cost) const {
+    const JumpTable &table = grid.jumps;
+    CellId cell = grid.index(x, y);
+    int dir = dy > 0   ? JumpTable::UP
+              : dy < 0 ? JumpTable::DOWN
+              : dx > 0 ? JumpTable::RIGHT
+                       : JumpTable::LEFT;
+    int dist = table(cell, dir);
+    int reach = std::abs(dist);
+    int tx = grid.cellX(target);
+    int ty = grid.cellY(target);
+    int steps = 0;
+    if (dy == 0) {
+        int ahead = (tx - x) * dx;
+        if (ty == y && ahead > 0 && ahead <= reach) steps = ahead;
+    } else {
+        int ahead = (ty - y) * dy;
+        if (ahead > 0 && ahead <= reach) {
+            int side = table(grid.index(x, ty),
+                             tx > x ? JumpTable::RIGHT : JumpTable::LEFT);
+            if (tx == x || (side <= 0 && std::abs(tx - x) <= -side))
+                steps = ahead;
+        }
+    }
+    if (steps == 0) {
+        if (dist <= 0) return NO_CELL;
+        steps = dist;
+    }
+    cost += grid.cost(cell);
+    if (steps > 1)
+        cost += (steps - 1) * grid.cost(grid.index(x + dx, y + dy));
+    return grid.index(x + dx * steps, y + dy * steps);
+}
+
+void JPSSolver::startSearch(const GridMap &grid, CellId start,
+                            CellId goal) {
+    target = goal;
+    SearchWorkspace &ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    ws.cost.set(start, 0);
+    open.push(start, 0);
+}
+
+CellId JPSSolver::expandNext(const GridMap &grid) {
+    SearchWorkspace &ws = *workspace;
+    CellId cell;
+    do {
+        if (open.empty()) return NO_CELL;
+        cell = open.pop().second;
+    } while (ws.closed.test(cell));
+    ws.closed.set(cell);
+    if (cell == target) return cell;
+
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    // Directions to scan: all four from the start and from non-uniform
+    // cells, otherwise the natural and forced ones for the arrival
+    // direction.
+    std::pair<int, int> scan[4];
+    int count = 0;
+    CellId parent = ws.parent[cell];
+    if (parent == NO_CELL || !JumpTable::uniform(grid, x, y)) {
+        for (const Move &move : FourConnected::moves)
+            scan[count++] = {move.dx, move.dy};
+    } else {
+        int px = grid.cellX(parent);
+        int py = grid.cellY(parent);
+        if (px == x) {
+            int dy = y > py ? 1 : -1;
+            scan[count++] = {0, dy};
+            scan[count++] = {1, 0};
+            scan[count++] = {-1, 0};
+        } else {
+            int dx = x > px ? 1 : -1;
+            scan[count++] = {dx, 0};
+            for (int sy : {-1, 1}) {
+                if (!JumpTable::blocked(grid, x, y + sy) &&
+                    JumpTable::blocked(grid, x - dx, y + sy))
+                    scan[count++] = {0, sy};
+            }
+        }
+    }
+
+    bool lookup = precomputed && grid.jumps.built();
+    for (int i = 0; i < count; i++) {
+        auto [dx, dy] = scan[i];
+        int newCost = ws.cost[cell];
+        CellId next =
+            lookup    ? jumpPrecomputed(grid, x, y, dx, dy, newCost)
+            : dy == 0 ? jumpHorizontal(grid, x, y, dx, newCost)
+                      : jumpVertical(grid, x, y, dy, newCost);
+        if (next == NO_CELL) continue;
+        if (ws.closed.test(next) || newCost >= ws.cost[next]) continue;
+        ws.cost.set(next, newCost);
+        ws.parent.set(next, cell);
+        open.push(next, newCost + calculateHeuristic(grid, next));
+    }
+    return cell;
+}
+
+// Parents are jump points, so the straight segments between them are
+// filled in.
+int JPSSolver::buildPath(const GridMap &grid, CellId start, CellId goal,
+                         std::vector<CellId> &path) {
+    SearchWorkspace &ws = *workspace;
+    path.clear();
+    CellId cell = goal;
+    int totalCost = 0;
+    while (cell != start) {
+        CellId parent = ws.parent[cell];
+        int step = 1;
+        if (grid.cellY(cell) != grid.cellY(parent)) step = grid.n;
+        if (cell < parent) step = -step;
+        for (; cell != parent; cell -= step) {
+            path.push_back(cell);
+            totalCost += grid.cost(cell);
+        }
+    }
+    totalCost += grid.cost(cell);
+    path.push_back(cell);
+    std::reverse(path.begin(), path.end());
+    return totalCost;
+}
@@ -0,0 +1,62 @@
+#ifndef JPS_HPP
+#define JPS_HPP
+
+#include <string>
+#include <vector>
+
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Jump Point Search on the 4-connected grid.
+//
+// Canonical paths move vertically first and turn horizontally. A vertical
+// jump continues until a horizontal scan from one of its cells finds a
+// jump point; a horizontal jump continues until a vertical neighbour is
+// forced open by a wall behind it. Only the jump points are pushed to the
+// open list.
+//
+// Pruning is only valid where the terrain is uniform, so a jump also stops
+// at every cell whose 3x3 neighbourhood contains a passable cell with a
+// different cost (e.g. the border of FOREST or WATER), and such cells are
+// expanded in all four directions like in plain A*. This keeps the search
+// optimal on weighted terrain.
+class JPSSolver : public Solver {
+    QuaternaryHeap open;
+
+    int calculateHeuristic(const GridMap &grid, CellId cell) {
+        return std::abs((int)grid.cellX(cell) - (int)grid.cellX(target)) +
+               std::abs((int)grid.cellY(cell) - (int)grid.cellY(target));
+    };
+
+    CellId jumpHorizontal(const GridMap &grid, int x, int y, int dx,
+                          int &cost) const;
+    CellId jumpVertical(const GridMap &grid, int x, int y, int dy,
+                        int &cost) const;
+    CellId jumpPrecomputed(const GridMap &grid, int x, int y, int dx,
+                           int dy, int &cost) const;
+
+   protected:
+    // Read the jumps from GridMap::jumps when it is built (JPS+).
+    bool precomputed = false;
+
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    std::string getName() override { return "JPS Solver"; }
+};
+
+// JPS+: the same search, but every jump is a lookup in the map's jump
+// table instead of a scan. The solver only reads the map, so call
+// GridMap::buildJumpTable() first; without a table it falls back to
+// scanning.
+class JPSPlusSolver : public JPSSolver {
+   public:
+    JPSPlusSolver() { precomputed = true; }
+    std::string getName() override { return "JPS+ Solver"; }
+};
+
+#endif
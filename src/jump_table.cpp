@@ -0,0 +1,120 @@
+#include "jump_table.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "grid_map.hpp"
+
+bool JumpTable::blocked(const GridMap &grid, int x, int y) {
+    return x < 0 || x >= grid.n || y < 0 || y >= grid.m ||
+           !grid.passable[grid.index(x, y)];
+}
+
+bool JumpTable::uniform(const GridMap &grid, int x, int y) {
+    int cost = grid.cost(grid.index(x, y));
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (blocked(grid, x + dx, y + dy)) continue;
+            if (grid.cost(grid.index(x + dx, y + dy)) != cost)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool JumpTable::forced(const GridMap &grid, int x, int y, int dx) {
+    for (int sy : {-1, 1}) {
+        if (!blocked(grid, x, y + sy) && blocked(grid, x - dx, y + sy))
+            return true;
+    }
+    return false;
+}
+
+// Distance from a cell given the state of its neighbour in the scanned
+// direction. Runs too long for 16 bits get an extra jump point, which the
+// search handles like any other.
+static std::int16_t extend(bool wall, bool jump, std::int16_t next) {
+    if (wall) return 0;
+    if (jump) return 1;
+    if (next > 0) return next < INT16_MAX ? next + 1 : 1;
+    return next > -INT16_MAX ? next - 1 : 1;
+}
+
+void JumpTable::buildRow(const GridMap &grid, int y) {
+    CellId row = grid.index(0, y);
+    for (int x = grid.n - 1; x >= 0; x--) {
+        bool wall = blocked(grid, x + 1, y);
+        bool jump = !wall && (!uniform(grid, x + 1, y) ||
+                              forced(grid, x + 1, y, 1));
+        store(row + x, RIGHT,
+              extend(wall, jump, wall ? 0 : dist[row + x + 1][RIGHT]));
+    }
+    for (int x = 0; x < grid.n; x++) {
+        bool wall = blocked(grid, x - 1, y);
+        bool jump = !wall && (!uniform(grid, x - 1, y) ||
+                              forced(grid, x - 1, y, -1));
+        store(row + x, LEFT,
+              extend(wall, jump, wall ? 0 : dist[row + x - 1][LEFT]));
+    }
+}
+
+// Recomputes `dir` (UP or DOWN) of column x, starting at row y and walking
+// against the direction. Past row `settled` the walk stops at the first
+// value that did not change, the rest of the column depends only on it.
+void JumpTable::buildColumn(const GridMap &grid, int x, int y, int dir,
+                            int settled) {
+    int step = dir == UP ? 1 : -1;
+    for (; y >= 0 && y < grid.m; y -= step) {
+        int ny = y + step;
+        bool wall = blocked(grid, x, ny);
+        std::int16_t value = 0;
+        if (!wall) {
+            CellId next = grid.index(x, ny);
+            bool jump = !uniform(grid, x, ny) || dist[next][LEFT] > 0 ||
+                        dist[next][RIGHT] > 0;
+            value = extend(false, jump, dist[next][dir]);
+        }
+        CellId id = grid.index(x, y);
+        if ((y - settled) * step < 0 && dist[id][dir] == value) break;
+        store(id, dir, value);
+    }
+}
+
+void JumpTable::build(const GridMap &grid) {
+    dist.assign(grid.size(), {0, 0, 0, 0});
+    for (int y = 0; y < grid.m; y++) buildRow(grid, y);
+    for (int x = 0; x < grid.n; x++) {
+        buildColumn(grid, x, grid.m - 1, UP, -1);
+        buildColumn(grid, x, 0, DOWN, grid.m);
+    }
+}
+
+void JumpTable::update(const GridMap &grid, int x, int y) {
+    // Jump points depend on the 3x3 block around a cell, so the changed
+    // cell affects the rows next to it. A column depends on those rows
+    // through the uniformity and walls around (x, y), and through whether
+    // its cells in them have a horizontal jump point, so only the columns
+    // next to x and those whose flag changed are walked again.
+    int top = std::max(y - 1, 0);
+    int bottom = std::min(y + 1, grid.m - 1);
+    auto jumps = [&](CellId id) {
+        return dist[id][LEFT] > 0 || dist[id][RIGHT] > 0;
+    };
+    std::vector<std::uint8_t> rescan(grid.n, 0);
+    for (int c = std::max(x - 1, 0); c <= std::min(x + 1, grid.n - 1); c++)
+        rescan[c] = 1;
+    std::vector<std::uint8_t> before(grid.n);
+    for (int r = top; r <= bottom; r++) {
+        CellId row = grid.index(0, r);
+        for (int c = 0; c < grid.n; c++) before[c] = jumps(row + c);
+        buildRow(grid, r);
+        for (int c = 0; c < grid.n; c++)
+            rescan[c] |= before[c] != jumps(row + c);
+    }
+    for (int c = 0; c < grid.n; c++) {
+        if (!rescan[c]) continue;
+        buildColumn(grid, c, bottom, UP, y - 1);
+        buildColumn(grid, c, top, DOWN, y + 1);
+    }
+}
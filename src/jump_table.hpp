@@ -0,0 +1,57 @@
+#ifndef JUMP_TABLE_HPP
+#define JUMP_TABLE_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "paged_array.hpp"
+#include "utils.hpp"
+
+struct GridMap;
+
+// Precomputed jump distances for JPS+ (see jps.hpp). For every cell and each
+// of the four directions, in the order of FourConnected::moves (+y, -y,
+// +x, -x), it stores
+//
+//   d > 0   the next jump point is d steps away
+//   d <= 0  there is no jump point, -d free steps lead up to a wall
+//
+// The goal is not part of the table, the solver checks for it at query
+// time. The table is built on demand and then kept up to date by
+// GridMap::setTerrain, which only re-scans the rows around the changed
+// cell and the column segments depending on them.
+class JumpTable {
+    PagedArray<std::array<std::int16_t, 4>> dist;
+
+    // Writes only changed values, so that an update copies only the pages
+    // it changes when the table is shared with an older map version.
+    void store(CellId id, int dir, std::int16_t value) {
+        if (dist[id][dir] != value) dist.edit(id)[dir] = value;
+    }
+    void buildRow(const GridMap &grid, int y);
+    void buildColumn(const GridMap &grid, int x, int y, int dir,
+                     int settled);
+
+   public:
+    static constexpr int UP = 0;
+    static constexpr int DOWN = 1;
+    static constexpr int RIGHT = 2;
+    static constexpr int LEFT = 3;
+
+    // Jump point rules shared with the online search. A cell is uniform if
+    // every passable cell of its 3x3 block has the same cost; a horizontal
+    // move along dx forces a vertical neighbour that is open while the cell
+    // behind it is blocked.
+    static bool blocked(const GridMap &grid, int x, int y);
+    static bool uniform(const GridMap &grid, int x, int y);
+    static bool forced(const GridMap &grid, int x, int y, int dx);
+
+    bool built() const { return dist.size() != 0; }
+    int operator()(CellId id, int dir) const { return dist[id][dir]; }
+
+    void build(const GridMap &grid);
+    // Updates the table after the terrain of (x, y) changed.
+    void update(const GridMap &grid, int x, int y);
+};
+
+#endif
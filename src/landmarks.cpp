@@ -0,0 +1,271 @@
+#include "landmarks.hpp"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "grid_map.hpp"
+#include "movement.hpp"
+
+namespace {
+
+constexpr std::uint32_t UNREACHABLE = Landmarks::UNREACHABLE;
+
+// Calls f(i) for i in [0, count) on all hardware threads.
+template <typename F>
+void parallelFor(int count, F f) {
+    std::atomic<int> next{0};
+    auto work = [&] {
+        for (int i; (i = next++) < count;) f(i);
+    };
+    std::vector<std::thread> threads;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1; t < threadCount && t < (unsigned)count; t++)
+        threads.emplace_back(work);
+    work();
+    for (std::thread &thread : threads) thread.join();
+}
+
+// Dijkstra from `source` to every cell, or with `reverse` from every cell
+// to `source`. Moves cost less than `ring`, so the open cells fit in a
+// ring of that many buckets (Dial's algorithm). `order`, if given, gets
+// the cells in the order they are settled and `parent` their parents in
+// the shortest path tree.
+void flood(const GridMap &grid, CellId source, bool reverse, int ring,
+           std::vector<std::uint32_t> &dist,
+           std::vector<CellId> *order = nullptr,
+           std::vector<CellId> *parent = nullptr) {
+    dist.assign(grid.size(), UNREACHABLE);
+    if (order) order->clear();
+    if (parent) parent->assign(grid.size(), NO_CELL);
+    std::vector<std::vector<CellId>> buckets(ring);
+    dist[source] = 0;
+    buckets[0].push_back(source);
+    std::size_t queued = 1;
+    for (std::uint32_t cost = 0; queued > 0; cost++) {
+        std::vector<CellId> &bucket = buckets[cost % ring];
+        queued -= bucket.size();
+        // relaxing with a positive cost never adds to the current bucket
+        for (CellId cell : bucket) {
+            if (dist[cell] != cost) continue;
+            if (order) order->push_back(cell);
+            int x = grid.cellX(cell);
+            int y = grid.cellY(cell);
+            int leaving = grid.cost(cell);
+            forEachMove<FourConnected>([&](const Move &move) {
+                int nx = x + move.dx;
+                int ny = y + move.dy;
+                if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+                CellId next = grid.index(nx, ny);
+                if (!grid.passable[next]) return;
+                // backwards, `next` is the cell the move leaves
+                int step = (reverse ? grid.cost(next) : leaving) * move.cost;
+                std::uint32_t newCost = cost + step;
+                if (newCost >= dist[next]) return;
+                dist[next] = newCost;
+                if (parent) (*parent)[next] = cell;
+                buckets[newCost % ring].push_back(next);
+                queued++;
+            });
+        }
+        bucket.clear();
+    }
+}
+
+// The cell of `candidates` with the largest finite `dist`, NO_CELL if none
+// is above 0.
+CellId farthest(const std::vector<CellId> &candidates,
+                const std::vector<std::uint32_t> &dist) {
+    CellId best = NO_CELL;
+    std::uint32_t bestDist = 0;
+    for (CellId cell : candidates) {
+        if (dist[cell] != UNREACHABLE && dist[cell] > bestDist) {
+            best = cell;
+            bestDist = dist[cell];
+        }
+    }
+    return best;
+}
+
+// Picks the landmarks, flooding forward from each as it is picked; the
+// next pick depends on those costs.
+class Selection {
+    const GridMap &grid;
+    int ring;
+    std::mt19937 rng;
+    // cells reached from the first landmark, where the rest are placed
+    std::vector<CellId> region;
+
+    // The landmarks' lower bound on d(from, to) from the forward tables.
+    long long bound(CellId from, CellId to) const {
+        long long best = 0;
+        for (const std::vector<std::uint32_t> &dist : forward) {
+            if (dist[from] != UNREACHABLE && dist[to] != UNREACHABLE)
+                best = std::max(best, (long long)dist[to] - dist[from]);
+        }
+        return best;
+    }
+
+    void add(CellId cell) {
+        cells.push_back(cell);
+        forward.emplace_back();
+        flood(grid, cell, false, ring, forward.back());
+    }
+
+    CellId pickFarthest(std::vector<std::uint32_t> &nearest) {
+        const std::vector<std::uint32_t> &last = forward.back();
+        for (CellId cell : region)
+            nearest[cell] = std::min(nearest[cell], last[cell]);
+        return farthest(region, nearest);
+    }
+
+    // Grows a shortest path tree from a random root and weighs every cell
+    // by how much the landmarks underestimate its cost from the root. The
+    // landmark is the leaf reached from the heaviest subtree that holds no
+    // landmark yet by always descending into the heaviest child.
+    CellId pickAvoid(std::vector<std::uint32_t> &dist,
+                     std::vector<CellId> &order, std::vector<CellId> &parent,
+                     std::vector<long long> &weight,
+                     std::vector<std::uint8_t> &covered) {
+        CellId root = region[rng() % region.size()];
+        flood(grid, root, false, ring, dist, &order, &parent);
+        for (CellId cell : order) {
+            weight[cell] = 0;
+            covered[cell] = 0;
+        }
+        for (CellId cell : cells) covered[cell] = 1;
+        for (std::size_t i = order.size(); i-- > 0;) {
+            CellId cell = order[i];
+            if (covered[cell]) {
+                weight[cell] = 0;
+            } else {
+                weight[cell] += dist[cell] - bound(root, cell);
+            }
+            CellId up = parent[cell];
+            if (up == NO_CELL) continue;
+            covered[up] |= covered[cell];
+            weight[up] += weight[cell];
+        }
+        // covered subtrees weigh 0
+        CellId leaf = NO_CELL;
+        long long heaviestWeight = 0;
+        for (CellId cell : order) {
+            if (weight[cell] > heaviestWeight) {
+                leaf = cell;
+                heaviestWeight = weight[cell];
+            }
+        }
+        while (leaf != NO_CELL) {
+            CellId heaviest = NO_CELL;
+            int x = grid.cellX(leaf);
+            int y = grid.cellY(leaf);
+            forEachMove<FourConnected>([&](const Move &move) {
+                int nx = x + move.dx;
+                int ny = y + move.dy;
+                if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+                CellId next = grid.index(nx, ny);
+                if (parent[next] != leaf || weight[next] == 0) return;
+                if (heaviest == NO_CELL || weight[next] > weight[heaviest])
+                    heaviest = next;
+            });
+            if (heaviest == NO_CELL) return leaf;
+            leaf = heaviest;
+        }
+        return NO_CELL;
+    }
+
+   public:
+    std::vector<CellId> cells;
+    std::vector<std::vector<std::uint32_t>> forward;
+
+    Selection(const GridMap &grid, int ring)
+        // a fixed seed, so a map always gets the same landmarks
+        : grid(grid), ring(ring), rng(grid.size()) {}
+
+    void run(const std::vector<CellId> &open, int count,
+             LandmarkStrategy strategy) {
+        // The first landmark is the cell farthest from a random one. A
+        // root in a small pocket of the map would keep them all there, so
+        // a few roots are tried and the one reaching most cells is kept.
+        std::vector<std::uint32_t> dist;
+        CellId first = open[0];
+        std::size_t reached = 0;
+        for (int attempt = 0; attempt < 4 && reached * 2 <= open.size();
+             attempt++) {
+            CellId root = open[rng() % open.size()];
+            flood(grid, root, false, ring, dist);
+            std::size_t n = 0;
+            for (CellId cell : open) n += dist[cell] != UNREACHABLE;
+            if (n <= reached) continue;
+            reached = n;
+            first = farthest(open, dist);
+            if (first == NO_CELL) first = root;
+        }
+        add(first);
+        for (CellId cell : open) {
+            if (forward[0][cell] != UNREACHABLE) region.push_back(cell);
+        }
+
+        std::vector<std::uint32_t> nearest(grid.size(), UNREACHABLE);
+        std::vector<CellId> order, parent;
+        std::vector<long long> weight(grid.size());
+        std::vector<std::uint8_t> covered(grid.size());
+        // an avoid pick fails when its root's tree is all covered
+        for (int attempts = 4 * count; (int)cells.size() < count &&
+                                       (int)cells.size() < (int)region.size() &&
+                                       attempts > 0;
+             attempts--) {
+            CellId next = strategy == LandmarkStrategy::FARTHEST
+                              ? pickFarthest(nearest)
+                              : pickAvoid(dist, order, parent, weight, covered);
+            if (next != NO_CELL) add(next);
+        }
+    }
+};
+
+}  // namespace
+
+Landmarks Landmarks::build(const GridMap &grid, int count,
+                           LandmarkStrategy strategy) {
+    Landmarks result;
+    result.used = strategy;
+    std::vector<CellId> open;
+    int ring = 1;
+    for (int cell = 0; cell < grid.size(); cell++) {
+        if (!grid.passable[cell]) continue;
+        open.push_back(cell);
+        ring = std::max(ring, grid.cost(cell) * FourConnected::STRAIGHT + 1);
+    }
+    if (open.empty() || count <= 0) return result;
+
+    Selection selection(grid, ring);
+    selection.run(open, count, strategy);
+    int k = selection.cells.size();
+    std::vector<std::vector<std::uint32_t>> backward(k);
+    parallelFor(k, [&](int i) {
+        flood(grid, selection.cells[i], true, ring, backward[i]);
+    });
+
+    // interleave the tables, a row of cells at a time
+    result.cells = selection.cells;
+    result.fromLandmark.resize((std::size_t)grid.size() * k);
+    result.toLandmark.resize((std::size_t)grid.size() * k);
+    parallelFor(grid.m, [&](int y) {
+        for (int x = 0; x < grid.n; x++) {
+            CellId cell = grid.index(x, y);
+            for (int i = 0; i < k; i++) {
+                result.fromLandmark[(std::size_t)cell * k + i] =
+                    selection.forward[i][cell];
+                result.toLandmark[(std::size_t)cell * k + i] =
+                    backward[i][cell];
+            }
+        }
+    });
+    return result;
+}
+
+std::size_t Landmarks::bytesPerLandmark() const {
+    if (cells.empty()) return 0;
+    return (fromLandmark.size() + toLandmark.size()) *
+           sizeof(std::uint32_t) / cells.size();
+}
@@ -0,0 +1,82 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils.hpp"
+
+struct GridMap;
+
+enum class LandmarkStrategy {
+    // Each landmark is the cell farthest from the ones already chosen.
+    FARTHEST,
+    // Each landmark is the leaf of the subtree of a shortest path tree
+    // that the current landmarks bound worst (Goldberg and Werneck).
+    AVOID,
+};
+
+// Landmark lower bounds for ALT (see alt.hpp) on the 4-connected grid. For
+// every landmark L the tables hold the exact costs d(L, v) and d(v, L) of
+// every cell v, and the triangle inequality gives
+//
+//   d(v, t) >= max(d(v, L) - d(t, L), d(L, t) - d(L, v)),
+//
+// which, unlike Manhattan distance, accounts for terrain costs and walls.
+// Costs are directed (a move costs the terrain of the cell it leaves), so
+// each landmark needs a flood in both directions; they run on all hardware
+// threads.
+//
+// The tables are stored per cell, the landmarks of a cell side by side, so
+// a bound reads two cache lines per cell. They take 8 bytes per cell and
+// landmark.
+//
+// Costs that only grow keep the bounds consistent, so GridMap::setTerrain
+// keeps the tables when a cell becomes dearer or a wall, and drops them
+// when one gets cheaper.
+class Landmarks {
+   public:
+    static constexpr std::uint32_t UNREACHABLE = UINT32_MAX;
+
+   private:
+    LandmarkStrategy used = LandmarkStrategy::AVOID;
+    std::vector<CellId> cells;
+    // fromLandmark[v * count + i] = d(L_i, v), toLandmark likewise d(v, L_i)
+    std::vector<std::uint32_t> fromLandmark;
+    std::vector<std::uint32_t> toLandmark;
+
+   public:
+    // Chooses up to `count` landmarks among the passable cells (fewer if
+    // the map has fewer) and computes their tables.
+    static Landmarks build(const GridMap &grid, int count,
+                           LandmarkStrategy strategy);
+
+    int count() const { return cells.size(); }
+    LandmarkStrategy strategy() const { return used; }
+    const std::vector<CellId> &landmarkCells() const { return cells; }
+    std::size_t bytesPerLandmark() const;
+
+    // Lower bound on the cost of the cheapest path from `cell` to `goal`,
+    // not counting the goal's terrain.
+    int lowerBound(CellId cell, CellId goal) const {
+        std::size_t k = cells.size();
+        if (k == 0) return 0;
+        const std::uint32_t *fromCell = &fromLandmark[cell * k];
+        const std::uint32_t *fromGoal = &fromLandmark[goal * k];
+        const std::uint32_t *toCell = &toLandmark[cell * k];
+        const std::uint32_t *toGoal = &toLandmark[goal * k];
+        long long best = 0;
+        for (std::size_t i = 0; i < k; i++) {
+            // unreachable entries give no bound
+            if (toCell[i] != UNREACHABLE && toGoal[i] != UNREACHABLE)
+                best = std::max(best, (long long)toCell[i] - toGoal[i]);
+            if (fromGoal[i] != UNREACHABLE && fromCell[i] != UNREACHABLE)
+                best = std::max(best, (long long)fromGoal[i] - fromCell[i]);
+        }
+        return (int)best;
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "line_of_sight.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+int lineCost(const GridMap &grid, CellId from, CellId to) {
+    int x0 = grid.cellX(from);
+    int y0 = grid.cellY(from);
+    int x1 = grid.cellX(to);
+    int y1 = grid.cellY(to);
+    int nx = std::abs(x1 - x0);
+    int ny = std::abs(y1 - y0);
+    CellId xStep = x1 > x0 ? 1 : -1;
+    CellId yStep = y1 > y0 ? grid.n : -grid.n;
+
+    CellId id = from;
+    int maxCost = grid.cost(from);
+    for (int ix = 0, iy = 0; ix < nx || iy < ny;) {
+        // the next border crossed is the vertical one if
+        // (ix + 1/2) / nx < (iy + 1/2) / ny
+        int decision = (1 + 2 * ix) * ny - (1 + 2 * iy) * nx;
+        if (decision == 0) {
+            CellId a = id + xStep;
+            CellId b = id + yStep;
+            if (!grid.passable[a] || !grid.passable[b]) return -1;
+            maxCost = std::max({maxCost, grid.cost(a), grid.cost(b)});
+            id += xStep + yStep;
+            ix++;
+            iy++;
+        } else if (decision < 0) {
+            id += xStep;
+            ix++;
+        } else {
+            id += yStep;
+            iy++;
+        }
+        if (!grid.passable[id]) return -1;
+        if (id != to) maxCost = std::max(maxCost, grid.cost(id));
+    }
+    return maxCost;
+}
@@ -0,0 +1,17 @@
+#ifndef LINE_OF_SIGHT_HPP
+#define LINE_OF_SIGHT_HPP
+
+#include "grid_map.hpp"
+#include "utils.hpp"
+
+// Walks the supercover of the segment between the centres of `from` and
+// `to`: every cell the segment passes through, and both cells beside a
+// grid corner it crosses exactly, so a line cannot slip between two
+// diagonal walls. Only the passable array is consulted for blocking.
+//
+// Returns -1 if a covered cell is impassable, otherwise the highest
+// terrain cost among the covered cells except `to`. The cost of moving
+// along the segment is its length times that value.
+int lineCost(const GridMap &grid, CellId from, CellId to);
+
+#endif
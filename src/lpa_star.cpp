@@ -0,0 +1,130 @@
+#include "lpa_star.hpp"
+
+#include <algorithm>
+
+template <typename Movement>
+auto BasicLPAStarSolver<Movement>::key(const GridMap &grid, CellId cell)
+    -> Key {
+    int cost = std::min(g(cell), rhs[cell]);
+    if (cost >= INF) return {INF, INF};
+    return {cost + calculateHeuristic(grid, cell), cost};
+}
+
+// Cheapest way from the start through one move into `cell`, INF if there
+// is none. `best` receives the cell that move leaves.
+template <typename Movement>
+int BasicLPAStarSolver<Movement>::lookbehind(const GridMap &grid,
+                                             CellId cell, CellId *best) {
+    int result = INF;
+    if (!grid.passable[cell]) return result;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    forEachMove<Movement>([&](const Move &move) {
+        int px = x - move.dx;
+        int py = y - move.dy;
+        if (px < 0 || px >= grid.n || py < 0 || py >= grid.m) return;
+        CellId prev = grid.index(px, py);
+        if (!grid.passable[prev] || g(prev) >= INF) return;
+        if (!Movement::allowed(grid, px, py, move)) return;
+        int cost = g(prev) + grid.cost(prev) * move.cost;
+        if (cost < result) {
+            result = cost;
+            if (best) *best = prev;
+        }
+    });
+    return result;
+}
+
+template <typename Movement>
+void BasicLPAStarSolver<Movement>::updateVertex(const GridMap &grid,
+                                                CellId cell) {
+    if (cell != source) rhs.set(cell, lookbehind(grid, cell));
+    if (g(cell) != rhs[cell]) {
+        open.update(cell, key(grid, cell));
+    } else {
+        open.remove(cell);
+    }
+}
+
+// Updates every cell reachable from `cell` in one move.
+template <typename Movement>
+void BasicLPAStarSolver<Movement>::updateSuccessors(const GridMap &grid,
+                                                    CellId cell) {
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    forEachMove<Movement>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        updateVertex(grid, grid.index(nx, ny));
+    });
+}
+
+template <typename Movement>
+bool BasicLPAStarSolver<Movement>::consistent(const GridMap &grid) {
+    if (g(target) != rhs[target]) return false;
+    return open.empty() || open.top().first >= key(grid, target);
+}
+
+template <typename Movement>
+void BasicLPAStarSolver<Movement>::startSearch(const GridMap &grid,
+                                               CellId start, CellId goal) {
+    SearchWorkspace &ws = *workspace;
+    open.reset(ws);
+    done = false;
+    expanded = 0;
+    if (!planned || start != source || goal != target ||
+        planned->n != grid.n || planned->m != grid.m) {
+        target = goal;
+        source = start;
+        ws.prepare(grid.size());
+        rhs.prepare(grid.size(), INF);
+        rhs.set(start, 0);
+        open.push(start, key(grid, start));
+        planned = grid;
+        return;
+    }
+    if (forEachChangedNeighbourhood(
+            *planned, grid, [&](CellId cell) { updateVertex(grid, cell); }))
+        planned = grid;
+}
+
+template <typename Movement>
+CellId BasicLPAStarSolver<Movement>::expandNext(const GridMap &grid) {
+    SearchWorkspace &ws = *workspace;
+    if (consistent(grid)) {
+        done = g(target) < INF;
+        return done ? target : NO_CELL;
+    }
+    CellId cell = open.top().second;
+    expanded++;
+    if (g(cell) > rhs[cell]) {
+        ws.cost.set(cell, rhs[cell]);
+        open.remove(cell);
+    } else {
+        ws.cost.set(cell, INF);
+        updateVertex(grid, cell);
+    }
+    updateSuccessors(grid, cell);
+    return cell;
+}
+
+// Walks back from the goal over the cheapest moves into each cell; the g
+// values along it are exact once the goal is consistent.
+template <typename Movement>
+int BasicLPAStarSolver<Movement>::buildPath(const GridMap &grid,
+                                            CellId start, CellId goal,
+                                            std::vector<CellId> &path) {
+    path.clear();
+    CellId cell = goal;
+    path.push_back(cell);
+    while (cell != start && path.size() <= (std::size_t)grid.size()) {
+        lookbehind(grid, cell, &cell);
+        path.push_back(cell);
+    }
+    std::reverse(path.begin(), path.end());
+    return g(goal) + grid.cost(goal) * straightCost;
+}
+
+template class BasicLPAStarSolver<FourConnected>;
+template class BasicLPAStarSolver<EightConnected>;
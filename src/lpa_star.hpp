@@ -0,0 +1,74 @@
+#ifndef LPA_STAR_HPP
+#define LPA_STAR_HPP
+
+#include <climits>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "grid_map.hpp"
+#include "movement.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Lifelong Planning A*: an A* from the start whose results are kept and
+// repaired when the map changes under fixed endpoints. Every cell keeps g,
+// its cost from the start, and rhs, the min over moves into it of (g of
+// the cell left + cost of the move). Cells where the two differ are queued
+// with key
+//
+//   [min(g, rhs) + h(cell, goal), min(g, rhs)]
+//
+// and the search stops once the goal is consistent and no queued key is
+// below its own.
+//
+// Like BasicDStarLiteSolver, it diffs the map against the one of its last
+// query and only re-evaluates the cells around the changed ones; a query
+// with another start or goal starts afresh. The search state stays in the
+// workspace between queries, so it must not be shared with other solvers.
+template <typename Movement = FourConnected>
+class BasicLPAStarSolver : public Solver {
+    static constexpr int INF = INT_MAX / 4;
+    using Key = std::pair<int, int>;
+
+    IndexedHeap<4, Key> open;
+    EpochArray<int> rhs;
+    std::optional<GridMap> planned;
+    CellId source = NO_CELL;
+    bool done = false;
+
+    int calculateHeuristic(const GridMap &grid, CellId cell) {
+        return Movement::heuristic(
+            std::abs((int)grid.cellX(cell) - (int)grid.cellX(target)),
+            std::abs((int)grid.cellY(cell) - (int)grid.cellY(target)));
+    }
+    int g(CellId cell) const { return std::min(workspace->cost[cell], INF); }
+    Key key(const GridMap &grid, CellId cell);
+    int lookbehind(const GridMap &grid, CellId cell, CellId *best = nullptr);
+    void updateVertex(const GridMap &grid, CellId cell);
+    void updateSuccessors(const GridMap &grid, CellId cell);
+    bool consistent(const GridMap &grid);
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start, CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    bool pathFound(CellId) const override { return done; }
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    // Cells expanded by the last query. After the first one these are the
+    // re-expansions caused by the edits since the previous query.
+    std::size_t expanded = 0;
+
+    BasicLPAStarSolver() { straightCost = Movement::STRAIGHT; }
+    std::string getName() override {
+        return std::string("LPA* Solver") + Movement::SUFFIX;
+    }
+};
+
+using LPAStarSolver = BasicLPAStarSolver<>;
+
+#endif
@@ -5,15 +5,29 @@
 #include <iostream>
 #include <memory>
 #include <vector>
+#include "renderer/colors.hpp"
 #include "renderer/context.hpp"
+#include "alt.hpp"
+#include "bidirectional.hpp"
+#include "ch_solver.hpp"
+#include "cpd_solver.hpp"
+#include "dstar_lite.hpp"
+#include "hpa_star.hpp"
+#include "jps.hpp"
+#include "lpa_star.hpp"
 #include "problem.hpp"
 #include "solver.hpp"
+#include "theta_star.hpp"
 #include "utils.hpp"
 
 const double SOLVING_SPEED = 0.01;
 
 void processInput(GLFWwindow *window, double time, Problem &problem,
-                  DrawMode &drawingMode, std::unique_ptr<Solver> &solver);
+                  DrawMode &drawingMode, std::unique_ptr<Solver> &solver,
+                  std::shared_ptr<const GridMap> &searched);
+
+void processMouse(GLFWwindow *window, Problem &problem, DrawMode drawingMode,
+                  bool endsFixed);
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 
@@ -53,6 +67,8 @@ int main() {
     auto drawingMode = DrawMode::WALL;
     Problem problem = Problem(800 / 50, 600 / 50);
     std::unique_ptr<Solver> solver = std::make_unique<AStarSolver>();
+    // the map version the running search reads
+    std::shared_ptr<const GridMap> searched;
     glfwSetWindowTitle(window, solver->getName().c_str());
 
     double currentFrame = glfwGetTime();
@@ -63,14 +79,15 @@ int main() {
         currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
-        processInput(window, currentFrame, problem, drawingMode, solver);
+        processInput(window, currentFrame, problem, drawingMode, solver,
+                     searched);
         if (solver->solving &&
             currentFrame - solver->lastStepTime >= SOLVING_SPEED) {
             solver->lastStepTime = currentFrame;
-            int res = solver->stepSolve(problem);
-            glfwSetWindowTitle(window, (solver->getName() +
-                                        ". Path cost: " + std::to_string(res))
-                                           .c_str());
+            int res = solver->stepSolve(*searched, problem.state);
+            std::string status =
+                res < 0 ? ". No path" : ". Path cost: " + std::to_string(res);
+            glfwSetWindowTitle(window, (solver->getName() + status).c_str());
         }
 
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
@@ -92,8 +109,33 @@ int main() {
     return 0;
 }
 
+void processMouse(GLFWwindow *window, Problem &problem, DrawMode drawingMode,
+                  bool endsFixed) {
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+        double xpos, ypos;
+        glfwGetCursorPos(window, &xpos, &ypos);
+        int x = xpos / 50;
+        int y = (600 - ypos) / 50;
+        if (x >= 800 / 50 || y >= 600 / 50 || x < 0 || y < 0) return;
+        bool end = drawingMode == DrawMode::PATH_START ||
+                   drawingMode == DrawMode::PATH_GOAL;
+        if (!endsFixed || !end) problem.setCell(x, y, drawingMode);
+    }
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
+        double xpos, ypos;
+        glfwGetCursorPos(window, &xpos, &ypos);
+        int x = xpos / 50;
+        int y = (600 - ypos) / 50;
+        if (x >= 800 / 50 || y >= 600 / 50 || x < 0 || y < 0) return;
+        CellId id = problem.map()->index(x, y);
+        bool end = id == problem.state.start || id == problem.state.goal;
+        if (!endsFixed || !end) problem.clearCell(x, y);
+    }
+}
+
 void processInput(GLFWwindow *window, double time, Problem &problem,
-                  DrawMode &drawingMode, std::unique_ptr<Solver> &solver) {
+                  DrawMode &drawingMode, std::unique_ptr<Solver> &solver,
+                  std::shared_ptr<const GridMap> &searched) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
     if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) {
@@ -111,6 +153,9 @@ void processInput(GLFWwindow *window, double time, Problem &problem,
     if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS) {
         drawingMode = DrawMode::PATH_GOAL;
     }
+    // The terrain may change while solving, the search keeps reading the
+    // map version it started on. The start and the goal may not.
+    processMouse(window, problem, drawingMode, solver->solving);
     // Next input operations are not available during solving
     if (solver->solving) {
         return;
@@ -124,33 +169,86 @@ void processInput(GLFWwindow *window, double time, Problem &problem,
         solver = std::make_unique<DijkstraSolver>();
         glfwSetWindowTitle(window, solver->getName().c_str());
     }
+    if (glfwGetKey(window, GLFW_KEY_8) == GLFW_PRESS) {
+        solver = std::make_unique<JPSSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS) {
+        solver = std::make_unique<JPSPlusSolver>();
+        problem.maps.edit().buildJumpTable();
+        problem.maps.publish();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS) {
+        solver = std::make_unique<HPAStarSolver>();
+        // clusters small enough for the viewer's grid to have several
+        problem.maps.edit().buildClusters(4, 2);
+        problem.maps.publish();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) {
+        solver = std::make_unique<CHSolver>();
+        // edits drop the hierarchy, press K again after drawing
+        problem.maps.edit().buildHierarchy();
+        problem.maps.publish();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+        solver = std::make_unique<ALTSolver>();
+        problem.maps.edit().buildLandmarks();
+        problem.maps.publish();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
+        solver = std::make_unique<CPDSolver>();
+        // rows for every cell of the viewer's grid; edits drop them
+        GridMap &grid = problem.maps.edit();
+        grid.buildPathDatabase({{0, 0, grid.n, grid.m}});
+        problem.maps.publish();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
+        solver = std::make_unique<BasicAStarSolver<QuaternaryHeap, EightConnected>>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
+        solver = std::make_unique<ThetaStarSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS) {
+        solver = std::make_unique<LazyThetaStarSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS) {
+        solver = std::make_unique<BidirectionalAStarSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+        solver = std::make_unique<BidirectionalDijkstraSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    // these keep their search between solves, so after editing the map
+    // Backspace + Enter repairs the previous path instead of starting over
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+        solver = std::make_unique<DStarLiteSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+        solver = std::make_unique<LPAStarSolver>();
+        glfwSetWindowTitle(window, solver->getName().c_str());
+    }
     if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
-        problem = Problem(800 / 50, 600 / 50);
+        problem.clear();
         solver->solved = false;
         solver->solving = false;
     }
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
-        double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
-        int x = xpos / 50;
-        int y = (600 - ypos) / 50;
-        if (x >= 800 / 50 || y >= 600 / 50 || x < 0 || y < 0) return;
-        problem.setCell(x, y, drawingMode);
-    }
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
-        double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
-        int x = xpos / 50;
-        int y = (600 - ypos) / 50;
-        if (x >= 800 / 50 || y >= 600 / 50 || x < 0 || y < 0) return;
-        problem.clearCell(x, y);
-    }
     if (glfwGetKey(window, GLFW_KEY_BACKSPACE) == GLFW_PRESS) {
         solver->solved = false;
         problem.restart();
     }
     if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
-        solver->solve(problem);
+        searched = problem.map();
+        solver->solve(*searched, problem.state);
     }
 }
 
@@ -163,25 +261,30 @@ void drawGrid(Context &ctx, Problem &problem) {
         ctx.drawRectangle(0.0f, i, 800.0f, 2.0f, 0,
                           glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
     }
-    auto &grid = problem.grid;
-    for (int i = 0; i < grid.size(); i++) {
-        for (int j = 0; j < grid[i].size(); j++) {
-            ctx.drawRectangle(i * 50, j * 50, 50, 50, 0,
-                              getCellColor(grid[i][j]));
+    std::shared_ptr<const GridMap> current = problem.map();
+    const GridMap &map = *current;
+    const SearchState &state = problem.state;
+    for (int x = 0; x < map.n; x++) {
+        for (int y = 0; y < map.m; y++) {
+            CellId id = map.index(x, y);
+            ctx.drawRectangle(x * 50, y * 50, 50, 50, 0,
+                              getCellColor(map.type(id),
+                                           state.visited.test(id)));
         }
     }
-    if (problem.start) {
-        ctx.drawRectangle(problem.start->x * 50 + 10,
-                          problem.start->y * 50 + 10, 30, 30, 1,
+    if (state.start != NO_CELL) {
+        ctx.drawRectangle(map.cellX(state.start) * 50 + 10,
+                          map.cellY(state.start) * 50 + 10, 30, 30, 1,
                           glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
     }
-    if (problem.goal) {
-        ctx.drawRectangle(problem.goal->x * 50 + 10, problem.goal->y * 50 + 10,
-                          30, 30, 1, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+    if (state.goal != NO_CELL) {
+        ctx.drawRectangle(map.cellX(state.goal) * 50 + 10,
+                          map.cellY(state.goal) * 50 + 10, 30, 30, 1,
+                          glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
     }
-    for (const auto cell : problem.solution) {
-        int x = cell->x;
-        int y = cell->y;
+    for (const auto cell : state.solution) {
+        int x = map.cellX(cell);
+        int y = map.cellY(cell);
         ctx.drawRectangle(x * 50 + 15, y * 50 + 15, 20, 20, 2,
                           glm::vec4(1.0f, 0.0f, 1.0f, 1.0f));
     }
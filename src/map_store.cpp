@@ -0,0 +1,22 @@
+#include "map_store.hpp"
+
+#include <utility>
+
+MapStore::MapStore(GridMap map) : draft(std::move(map)) { publish(); }
+
+std::shared_ptr<const GridMap> MapStore::snapshot() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return published;
+}
+
+std::shared_ptr<const GridMap> MapStore::publish() {
+    draft.version++;
+    auto version = std::make_shared<const GridMap>(draft);
+    std::shared_ptr<const GridMap> old;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        old = std::exchange(published, version);
+    }
+    // the previous version is freed outside the lock if no reader holds it
+    return version;
+}
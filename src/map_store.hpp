@@ -0,0 +1,35 @@
+#ifndef MAP_STORE_HPP
+#define MAP_STORE_HPP
+
+#include <memory>
+#include <mutex>
+
+#include "grid_map.hpp"
+
+// Versions of a map that is edited while other threads run queries on it.
+// The writer changes a private draft and publish()es it; readers take the
+// latest published version with snapshot() and hold on to it for as long
+// as their queries run. A published version never changes.
+//
+// Publishing copies only the draft's page tables, so the new version
+// shares every page the draft did not edit since the last publish. The
+// copy is made before the lock is taken, which then only guards swapping
+// the published pointer. edit() and publish() must be called from one
+// thread at a time.
+class MapStore {
+    GridMap draft;
+    std::shared_ptr<const GridMap> published;
+    mutable std::mutex lock;
+
+   public:
+    explicit MapStore(GridMap map);
+
+    std::shared_ptr<const GridMap> snapshot() const;
+    // The writer's working copy. Changes are not visible to snapshot()
+    // until the next publish().
+    GridMap &edit() { return draft; }
+    // Makes the draft the current version and returns it.
+    std::shared_ptr<const GridMap> publish();
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef MOVEMENT_HPP
+#define MOVEMENT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// Movement models the solvers are instantiated with. A model lists its
+// moves and their fixed-point step costs; leaving a cell along a move costs
+// the cell's terrain cost times the step cost. The heuristic is the cost of
+// the best move sequence over CLEAR terrain (cost 1), so it is admissible
+// and consistent.
+//
+//   moves               std::array<Move, N>, iterated with forEachMove()
+//   STRAIGHT            step cost of an orthogonal move
+//   allowed(p, x, y, m) whether move m from (x, y) may be taken, given the
+//                       target cell is inside the grid and passable
+//   heuristic(dx, dy)   lower bound for |dx|, |dy| remaining
+
+struct Move {
+    int dx;
+    int dy;
+    int cost;
+};
+
+// Orthogonal moves of unit cost, Manhattan distance. The order (+y, -y, +x,
+// -x) is the one JPS and its jump table use.
+struct FourConnected {
+    static constexpr int STRAIGHT = 1;
+    static constexpr std::array<Move, 4> moves = {
+        {{0, 1, 1}, {0, -1, 1}, {1, 0, 1}, {-1, 0, 1}}};
+    static constexpr const char *SUFFIX = "";
+
+    template <typename Grid>
+    static bool allowed(const Grid &, int, int, const Move &) {
+        return true;
+    }
+    static int heuristic(int dx, int dy) { return dx + dy; }
+};
+
+// Orthogonal and diagonal moves with octile costs. 99/70 approximates
+// sqrt(2) to within 5e-5, close enough to agree with floating point octile
+// lengths, while path costs on the largest benchmark maps stay inside an
+// int. Without corner cutting a diagonal needs both orthogonal cells it
+// passes to be free; with it, one of them is enough, but the move still
+// cannot squeeze between two diagonal walls.
+template <bool CUT_CORNERS>
+struct Octile {
+    static constexpr int STRAIGHT = 70;
+    static constexpr int DIAGONAL = 99;
+    static constexpr std::array<Move, 8> moves = {{{0, 1, STRAIGHT},
+                                                   {0, -1, STRAIGHT},
+                                                   {1, 0, STRAIGHT},
+                                                   {-1, 0, STRAIGHT},
+                                                   {1, 1, DIAGONAL},
+                                                   {1, -1, DIAGONAL},
+                                                   {-1, 1, DIAGONAL},
+                                                   {-1, -1, DIAGONAL}}};
+    static constexpr const char *SUFFIX =
+        CUT_CORNERS ? " (8-connected, corner cutting)" : " (8-connected)";
+
+    template <typename Grid>
+    static bool allowed(const Grid &grid, int x, int y, const Move &move) {
+        if (move.dx == 0 || move.dy == 0) return true;
+        bool horizontal = grid.passable[grid.index(x + move.dx, y)];
+        bool vertical = grid.passable[grid.index(x, y + move.dy)];
+        return CUT_CORNERS ? horizontal || vertical : horizontal && vertical;
+    }
+    static int heuristic(int dx, int dy) {
+        return STRAIGHT * std::max(dx, dy) +
+               (DIAGONAL - STRAIGHT) * std::min(dx, dy);
+    }
+};
+
+using EightConnected = Octile<false>;
+using EightConnectedCutting = Octile<true>;
+
+// Any-angle movement (Theta*): the 8-connected moves plus straight
+// segments between cells in line of sight, see line_of_sight.hpp. Lengths
+// are Euclidean in the same fixed point; distance() rounds, so adjacent
+// cells keep the octile step costs, and heuristic() rounds down to stay
+// admissible.
+struct AnyAngle : EightConnected {
+    static constexpr const char *SUFFIX = " (any-angle)";
+
+    static int distance(int dx, int dy) {
+        return (int)std::lround(std::sqrt(double(dx * dx + dy * dy)) *
+                                STRAIGHT);
+    }
+    static int heuristic(int dx, int dy) {
+        return (int)(std::sqrt(double(dx * dx + dy * dy)) * STRAIGHT);
+    }
+};
+
+// Calls f(move) for every move of the model, unrolled at compile time.
+template <typename Movement, typename F>
+inline void forEachMove(F &&f) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (f(Movement::moves[I]), ...);
+    }(std::make_index_sequence<Movement::moves.size()>());
+}
+
+#endif
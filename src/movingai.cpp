@@ -0,0 +1,121 @@
+#include "movingai.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+static CellType tileToCellType(char tile) {
+    switch (tile) {
+        case '.':
+        case 'G':
+        case 'S':
+            return CellType::CLEAR;
+        default:
+            return CellType::WALL;
+    }
+}
+
+static char cellTypeToTile(CellType type) {
+    switch (type) {
+        case CellType::WALL:
+            return '@';
+        case CellType::CLEAR:
+            return '.';
+        default:
+            return 'S';
+    }
+}
+
+std::optional<GridMap> loadMovingAIMap(const std::string &path,
+                                       std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    int width = -1;
+    int height = -1;
+    std::string key;
+    while (in >> key && key != "map") {
+        if (key == "height") {
+            in >> height;
+        } else if (key == "width") {
+            in >> width;
+        } else if (key == "type") {
+            in >> key;
+        } else {
+            error = "unexpected header field '" + key + "'";
+            return std::nullopt;
+        }
+    }
+    if (key != "map" || width <= 0 || height <= 0) {
+        error = "missing or invalid map header";
+        return std::nullopt;
+    }
+
+    GridMap grid(width, height);
+    std::string row;
+    for (int y = 0; y < height; y++) {
+        if (!(in >> row) || (int)row.size() < width) {
+            error = "map row " + std::to_string(y) + " is missing or short";
+            return std::nullopt;
+        }
+        for (int x = 0; x < width; x++) {
+            grid.setTerrain(grid.index(x, y), tileToCellType(row[x]));
+        }
+    }
+    return grid;
+}
+
+bool saveMovingAIMap(const GridMap &grid, const std::string &path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "type octile\nheight " << grid.m << "\nwidth " << grid.n
+        << "\nmap\n";
+    std::string row(grid.n, '.');
+    for (int y = 0; y < grid.m; y++) {
+        for (int x = 0; x < grid.n; x++) {
+            row[x] = cellTypeToTile(grid.type(grid.index(x, y)));
+        }
+        out << row << '\n';
+    }
+    return bool(out);
+}
+
+std::optional<std::vector<ScenarioEntry>> loadMovingAIScenario(
+    const std::string &path, std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return std::nullopt;
+    }
+    std::vector<ScenarioEntry> entries;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line.rfind("version", 0) == 0) continue;
+        std::istringstream fields(line);
+        ScenarioEntry e;
+        if (!(fields >> e.bucket >> e.map >> e.width >> e.height >>
+              e.startX >> e.startY >> e.goalX >> e.goalY >> e.optimalLength)) {
+            error = "malformed scenario line " + std::to_string(lineNumber);
+            return std::nullopt;
+        }
+        entries.push_back(e);
+    }
+    return entries;
+}
+
+bool saveMovingAIScenario(const std::vector<ScenarioEntry> &entries,
+                          const std::string &path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "version 1\n" << std::fixed << std::setprecision(8);
+    for (const ScenarioEntry &e : entries) {
+        out << e.bucket << '\t' << e.map << '\t' << e.width << '\t'
+            << e.height << '\t' << e.startX << '\t' << e.startY << '\t'
+            << e.goalX << '\t' << e.goalY << '\t' << e.optimalLength << '\n';
+    }
+    return bool(out);
+}
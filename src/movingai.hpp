@@ -0,0 +1,47 @@
+#ifndef MOVINGAI_HPP
+#define MOVINGAI_HPP
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "grid_map.hpp"
+
+// Reader and writer for the Moving AI Lab grid benchmark formats.
+//
+// Map tiles are mapped onto CellType as follows:
+//   '.' 'G' 'S'  -> CLEAR
+//   '@' 'O' 'T'  -> WALL
+//   'W'          -> WALL
+// Trees are impassable in the benchmarks. Swamp is passable from ordinary
+// ground at the same cost, and water can only be entered from water, so no
+// path starting on land crosses it; entries starting or ending on water are
+// skipped by the scenario runner. The format has no terrain costs, so
+// FOREST and WATER cells are written as 'S' and load back as CLEAR.
+//
+// Scenario lengths are octile: diagonal steps cost sqrt(2) and may not cut
+// corners, the EightConnected movement model.
+//
+// Map rows are stored top to bottom, so a tile at (x, row) becomes cell
+// (x, row) and scenario coordinates can be used unchanged.
+
+struct ScenarioEntry {
+    int bucket;
+    std::string map;
+    int width;
+    int height;
+    unsigned int startX, startY;
+    unsigned int goalX, goalY;
+    double optimalLength;
+};
+
+std::optional<GridMap> loadMovingAIMap(const std::string &path,
+                                       std::string &error);
+bool saveMovingAIMap(const GridMap &grid, const std::string &path);
+
+std::optional<std::vector<ScenarioEntry>> loadMovingAIScenario(
+    const std::string &path, std::string &error);
+bool saveMovingAIScenario(const std::vector<ScenarioEntry> &entries,
+                          const std::string &path);
+
+#endif
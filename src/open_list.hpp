@@ -0,0 +1,254 @@
+#ifndef OPEN_LIST_HPP
+#define OPEN_LIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utils.hpp"
+#include "workspace.hpp"
+
+// Open lists the solvers can be instantiated with. They keep their entries
+// in the SearchWorkspace, so they are cheap views that are re-attached with
+// reset() at the start of every query.
+//
+//   void reset(SearchWorkspace &ws)   start a new, empty open list
+//   bool empty() const
+//   void push(CellId id, int key)     insert, or lower the key of `id`
+//   std::pair<int, CellId> top()      the entry with the smallest key
+//   std::pair<int, CellId> pop()      remove the entry with the smallest key
+//
+// IndexedHeap can also move an entry to any key and remove it, which the
+// incremental solvers need (see dstar_lite.hpp).
+
+struct Compare {
+    bool operator()(const std::pair<int, CellId> &a,
+                    const std::pair<int, CellId> &b) const {
+        return a.first > b.first;
+    }
+};
+
+// Binary heap without decrease-key: lowering a key pushes a duplicate entry
+// and the stale one is dropped by the solver's closed-set check when popped.
+class LazyBinaryHeap {
+    SearchWorkspace *ws = nullptr;
+
+   public:
+    void reset(SearchWorkspace &workspace) { ws = &workspace; }
+    bool empty() const { return ws->open.empty(); }
+    std::size_t size() const { return ws->open.size(); }
+    void push(CellId id, int key) {
+        ws->open.push_back({key, id});
+        std::push_heap(ws->open.begin(), ws->open.end(), Compare());
+    }
+    std::pair<int, CellId> top() const { return ws->open.front(); }
+    std::pair<int, CellId> pop() {
+        std::pop_heap(ws->open.begin(), ws->open.end(), Compare());
+        auto top = ws->open.back();
+        ws->open.pop_back();
+        return top;
+    }
+};
+
+// D-ary heap indexed by cell id with a true decrease-key: every cell is in
+// the heap at most once, so it never holds more entries than there are
+// cells. Keys are ints, or pairs compared lexicographically, kept in
+// SearchWorkspace::open and pairOpen respectively.
+template <int D, typename Key = int>
+class IndexedHeap {
+    static constexpr unsigned int NOT_IN_HEAP = ~0u;
+    using Entry = std::pair<Key, CellId>;
+    SearchWorkspace *ws = nullptr;
+
+    std::vector<Entry> &entries() const {
+        if constexpr (std::is_same_v<Key, int>) {
+            return ws->open;
+        } else {
+            return ws->pairOpen;
+        }
+    }
+    void place(unsigned int i, const Entry &entry) {
+        entries()[i] = entry;
+        ws->heapIndex.set(entry.second, i);
+    }
+    void siftUp(unsigned int i) {
+        auto &heap = entries();
+        auto entry = heap[i];
+        while (i > 0) {
+            unsigned int p = (i - 1) / D;
+            if (heap[p].first <= entry.first) break;
+            place(i, heap[p]);
+            i = p;
+        }
+        place(i, entry);
+    }
+    void siftDown(unsigned int i) {
+        auto &heap = entries();
+        auto entry = heap[i];
+        unsigned int n = heap.size();
+        while (true) {
+            unsigned int first = i * D + 1;
+            if (first >= n) break;
+            unsigned int best = first;
+            unsigned int last = std::min(first + D, n);
+            for (unsigned int c = first + 1; c < last; c++) {
+                if (heap[c].first < heap[best].first) best = c;
+            }
+            if (heap[best].first >= entry.first) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+
+   public:
+    void reset(SearchWorkspace &workspace) { ws = &workspace; }
+    bool empty() const { return entries().empty(); }
+    std::size_t size() const { return entries().size(); }
+    void push(CellId id, Key key) {
+        auto &heap = entries();
+        unsigned int i = ws->heapIndex[id];
+        if (i != NOT_IN_HEAP) {
+            if (key < heap[i].first) {
+                heap[i].first = key;
+                siftUp(i);
+            }
+            return;
+        }
+        heap.push_back({key, id});
+        siftUp(heap.size() - 1);
+    }
+    // Inserts `id`, or moves it to `key` whether that is lower or higher.
+    void update(CellId id, Key key) {
+        auto &heap = entries();
+        unsigned int i = ws->heapIndex[id];
+        if (i == NOT_IN_HEAP) {
+            push(id, key);
+            return;
+        }
+        Key old = heap[i].first;
+        heap[i].first = key;
+        if (key < old) {
+            siftUp(i);
+        } else {
+            siftDown(i);
+        }
+    }
+    void remove(CellId id) {
+        auto &heap = entries();
+        unsigned int i = ws->heapIndex[id];
+        if (i == NOT_IN_HEAP) return;
+        auto last = heap.back();
+        heap.pop_back();
+        ws->heapIndex.set(id, NOT_IN_HEAP);
+        if (i == heap.size()) return;
+        place(i, last);
+        if (i > 0 && heap[(i - 1) / D].first > last.first) {
+            siftUp(i);
+        } else {
+            siftDown(i);
+        }
+    }
+    Entry top() const { return entries()[0]; }
+    Entry pop() {
+        auto &heap = entries();
+        auto top = heap[0];
+        auto last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        ws->heapIndex.set(top.second, NOT_IN_HEAP);
+        return top;
+    }
+};
+
+using BinaryHeap = IndexedHeap<2>;
+using QuaternaryHeap = IndexedHeap<4>;
+
+// Monotone bucket queue (Dial's algorithm) for the small integer keys of
+// the terrain costs: a circular array of buckets, one per key, covering
+// the keys between the current minimum and the largest key pushed. push
+// and pop are O(1); the window only grows when the spread of the queued
+// keys exceeds it. Keys should not drop below the last popped key, which
+// holds for Dijkstra and for A* with a consistent heuristic. Lowering a key
+// pushes a duplicate, like LazyBinaryHeap.
+class BucketQueue {
+    SearchWorkspace *ws = nullptr;
+    int minKey = 0;          // key of the bucket at `cursor`
+    int maxKey = 0;          // upper bound of the keys in the queue
+    std::size_t cursor = 0;  // index of the bucket holding minKey
+    std::size_t count = 0;
+
+    // Re-lays the buckets into a window large enough for
+    // [newMin, newMax]. Buckets are moved, not copied, so they keep their
+    // capacity.
+    void grow(int newMin, int newMax) {
+        auto &buckets = ws->buckets;
+        std::size_t size = buckets.size();
+        while ((int)size < newMax - newMin + 1) size *= 2;
+        std::vector<std::vector<CellId>> old(size);
+        old.swap(buckets);
+        for (int k = minKey; k <= maxKey; k++) {
+            buckets[k - newMin].swap(
+                old[(cursor + (k - minKey)) & (old.size() - 1)]);
+        }
+        minKey = newMin;
+        cursor = 0;
+    }
+
+   public:
+    void reset(SearchWorkspace &workspace) {
+        ws = &workspace;
+        if (ws->buckets.empty()) ws->buckets.resize(64);
+        for (auto &bucket : ws->buckets) bucket.clear();
+        minKey = 0;
+        maxKey = 0;
+        cursor = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    void push(CellId id, int key) {
+        auto &buckets = ws->buckets;
+        int window = buckets.size();
+        if (count == 0) {
+            minKey = maxKey = key;
+        } else if (key < minKey) {
+            // slide the window down if it still covers maxKey
+            if (maxKey - key >= window) {
+                grow(key, maxKey);
+            } else {
+                cursor = (cursor - (minKey - key)) & (buckets.size() - 1);
+                minKey = key;
+            }
+        } else if (key - minKey >= window) {
+            grow(minKey, key);
+        }
+        maxKey = std::max(maxKey, key);
+        auto &bucket =
+            buckets[(cursor + (key - minKey)) & (buckets.size() - 1)];
+        bucket.push_back(id);
+        count++;
+    }
+    std::pair<int, CellId> top() {
+        auto &buckets = ws->buckets;
+        while (buckets[cursor].empty()) {
+            cursor = (cursor + 1) & (buckets.size() - 1);
+            minKey++;
+        }
+        return {minKey, buckets[cursor].back()};
+    }
+    std::pair<int, CellId> pop() {
+        auto &buckets = ws->buckets;
+        CellId id = top().second;
+        buckets[cursor].pop_back();
+        count--;
+        return {minKey, id};
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef PAGED_ARRAY_HPP
+#define PAGED_ARRAY_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Per-cell array split into fixed-size pages that copies of the array
+// share. Copying copies only the page table; edit() copies the page it
+// lands in first unless no other array holds it. A copy thus costs memory
+// in proportion to the pages edited afterwards, and a page is never
+// written while shared, so other threads may keep reading an older copy
+// while this one is edited.
+//
+// Reads cost one extra load over a flat array, the page table is small
+// enough to stay in cache.
+template <typename T>
+class PagedArray {
+   public:
+    static constexpr unsigned SHIFT = 12;
+    static constexpr std::size_t PAGE = std::size_t(1) << SHIFT;
+
+   private:
+    using Page = std::array<T, PAGE>;
+    std::vector<std::shared_ptr<Page>> pages;
+    std::size_t count = 0;
+
+   public:
+    // Sizes the array for `count` slots set to `value`. All pages start
+    // out as one shared page.
+    void assign(std::size_t count, const T &value) {
+        this->count = count;
+        auto page = std::make_shared<Page>();
+        page->fill(value);
+        pages.assign((count + PAGE - 1) / PAGE, page);
+    }
+
+    std::size_t size() const { return count; }
+
+    const T &operator[](std::size_t i) const {
+        return (*pages[i >> SHIFT])[i & (PAGE - 1)];
+    }
+
+    T &edit(std::size_t i) {
+        std::shared_ptr<Page> &page = pages[i >> SHIFT];
+        if (page.use_count() != 1) {
+            page = std::make_shared<Page>(*page);
+        } else {
+            // pairs with the release of the last other holder, whose reads
+            // of the page must be over before it is written
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return (*page)[i & (PAGE - 1)];
+    }
+
+    // Whether `other` holds exactly the pages of this array, as an
+    // unedited copy does.
+    bool sharesPages(const PagedArray &other) const {
+        return pages == other.pages;
+    }
+
+    // Calls f(i) for every slot whose value differs in `other`, an array
+    // of the same size. Pages the two share are skipped, so comparing two
+    // versions of a map takes time in proportion to the pages edited in
+    // between.
+    template <typename F>
+    void forEachDifference(const PagedArray &other, F f) const {
+        for (std::size_t p = 0; p < pages.size(); p++) {
+            if (pages[p] == other.pages[p]) continue;
+            std::size_t end = std::min(count, (p + 1) * PAGE);
+            for (std::size_t i = p * PAGE; i < end; i++) {
+                if ((*this)[i] != other[i]) f(i);
+            }
+        }
+    }
+};
+
+#endif
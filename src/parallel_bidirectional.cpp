@@ -0,0 +1,219 @@
+#include "parallel_bidirectional.hpp"
+
+#include <algorithm>
+
+template <typename OpenList, typename Movement, bool ASTAR>
+BasicParallelBidirectionalSolver<OpenList, Movement,
+                                 ASTAR>::~BasicParallelBidirectionalSolver() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::settle(
+    int s, CellId cell) {
+    std::uint64_t bit = 1ull << (cell % 64);
+    if (settled[s][cell / 64].fetch_or(bit) == 0)
+        dirty[s].push_back(cell / 64);
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::offerMeeting(
+    long long cost, CellId cell) {
+    std::uint64_t packed = (std::uint64_t)cost << 32 | cell;
+    std::uint64_t current = best.load();
+    while (packed < current && !best.compare_exchange_weak(current, packed)) {
+    }
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::startSearch(
+    const GridMap &grid, CellId start, CellId goal) {
+    source = start;
+    target = goal;
+    std::size_t words = (grid.size() + 63) / 64;
+    for (int s : {FORWARD, BACKWARD}) {
+        SearchWorkspace &ws = side(s);
+        ws.prepare(grid.size());
+        open[s].reset(ws);
+        if (settled[s].size() != words)
+            settled[s] = std::vector<std::atomic<std::uint64_t>>(words);
+        expanded[s] = 0;
+    }
+    workspace->cost.set(start, 0);
+    backward->cost.set(goal, 0);
+    open[FORWARD].push(start, potential(grid, start));
+    open[BACKWARD].push(goal, -potential(grid, goal));
+    radius[FORWARD] = potential(grid, start);
+    radius[BACKWARD] = -potential(grid, goal);
+    // the origins are final from the start, so a side that exhausts its
+    // open list has always met the other one if there is a path
+    settle(FORWARD, start);
+    settle(BACKWARD, goal);
+    best = start == goal ? (std::uint64_t)start : NO_MEETING;
+    stop = false;
+    done = false;
+    meet = NO_CELL;
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::run(
+    const GridMap &grid, int s) {
+    SearchWorkspace &ws = side(s);
+    SearchWorkspace &other = side(1 - s);
+    OpenList &list = open[s];
+    while (!stop.load(std::memory_order_relaxed)) {
+        if (list.empty()) {
+            stop = true;
+            break;
+        }
+        auto [key, cell] = list.top();
+        if (ws.closed.test(cell)) {
+            list.pop();
+            continue;
+        }
+        radius[s] = key;
+        std::uint64_t meeting = best.load();
+        if (meeting != NO_MEETING &&
+            key + radius[1 - s].load() >=
+                KEY_SCALE * (long long)(meeting >> 32)) {
+            stop = true;
+            break;
+        }
+        list.pop();
+        ws.closed.set(cell);
+        expanded[s]++;
+        settle(s, cell);
+        if (isSettled(1 - s, cell))
+            offerMeeting((long long)ws.cost[cell] + other.cost[cell], cell);
+
+        int x = grid.cellX(cell);
+        int y = grid.cellY(cell);
+        int cost = ws.cost[cell];
+        forEachMove<Movement>([&](const Move &move) {
+            // forward moves leave `cell`, backward ones arrive at it
+            int nx = s == FORWARD ? x + move.dx : x - move.dx;
+            int ny = s == FORWARD ? y + move.dy : y - move.dy;
+            if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m)
+                return;
+            CellId next = grid.index(nx, ny);
+            if (!grid.passable[next]) return;
+            if (s == FORWARD ? !Movement::allowed(grid, x, y, move)
+                             : !Movement::allowed(grid, nx, ny, move))
+                return;
+            if (ws.closed.test(next)) return;
+            CellId leaving = s == FORWARD ? cell : next;
+            int newCost = cost + grid.cost(leaving) * move.cost;
+            if (isSettled(1 - s, next))
+                offerMeeting((long long)std::min(newCost, ws.cost[next]) +
+                                 other.cost[next],
+                             next);
+            if (newCost >= ws.cost[next]) return;
+            ws.cost.set(next, newCost);
+            ws.parent.set(next, cell);
+            int p = potential(grid, next);
+            list.push(next, KEY_SCALE * newCost + (s == FORWARD ? p : -p));
+        });
+    }
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::search(
+    const GridMap &grid) {
+    if (!worker.joinable())
+        worker = std::thread(&BasicParallelBidirectionalSolver::loop, this);
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        searched = &grid;
+        running = true;
+        generation++;
+    }
+    wake.notify_one();
+    run(grid, FORWARD);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return !running; });
+    }
+    for (int s : {FORWARD, BACKWARD}) {
+        for (std::size_t word : dirty[s]) settled[s][word] = 0;
+        dirty[s].clear();
+    }
+    std::uint64_t meeting = best.load();
+    meet = meeting == NO_MEETING ? NO_CELL : (CellId)meeting;
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+void BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::loop() {
+    std::uint64_t seen = 0;
+    while (true) {
+        const GridMap *grid;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            grid = searched;
+        }
+        run(*grid, BACKWARD);
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            running = false;
+        }
+        finished.notify_one();
+    }
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+CellId BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::expandNext(
+    const GridMap &grid) {
+    search(grid);
+    done = meet != NO_CELL;
+    return meet;
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+SearchResult BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::findPath(
+    const GridMap &grid, CellId start, CellId goal) {
+    SearchResult result;
+    if (start == NO_CELL || goal == NO_CELL) return result;
+    if (!grid.passable[start] || !grid.passable[goal]) return result;
+    startSearch(grid, start, goal);
+    search(grid);
+    result.expansions = expanded[FORWARD] + expanded[BACKWARD];
+    if (meet == NO_CELL) return result;
+    result.found = true;
+    result.cost = buildPath(grid, start, goal, result.path);
+    return result;
+}
+
+template <typename OpenList, typename Movement, bool ASTAR>
+int BasicParallelBidirectionalSolver<OpenList, Movement, ASTAR>::buildPath(
+    const GridMap &grid, CellId start, CellId goal,
+    std::vector<CellId> &path) {
+    SearchWorkspace &fw = *workspace;
+    SearchWorkspace &bw = *backward;
+    path.clear();
+    for (CellId cell = meet; cell != start; cell = fw.parent[cell])
+        path.push_back(cell);
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    for (CellId cell = meet; cell != goal;) {
+        cell = bw.parent[cell];
+        path.push_back(cell);
+    }
+    return (int)(best.load() >> 32) + grid.cost(goal) * straightCost;
+}
+
+template class BasicParallelBidirectionalSolver<QuaternaryHeap, FourConnected,
+                                                true>;
+template class BasicParallelBidirectionalSolver<BucketQueue, FourConnected,
+                                                false>;
+template class BasicParallelBidirectionalSolver<QuaternaryHeap,
+                                                EightConnected, true>;
+template class BasicParallelBidirectionalSolver<BucketQueue, EightConnected,
+                                                false>;
@@ -0,0 +1,125 @@
+#ifndef PARALLEL_BIDIRECTIONAL_HPP
+#define PARALLEL_BIDIRECTIONAL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "movement.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Bidirectional search (see bidirectional.hpp) with the forward frontier on
+// the calling thread and the backward one on a second thread. The two
+// sides never touch each other's open lists; they share only
+//
+//   settled   one bit per cell and side, set when a side settles the cell.
+//             A side writes the cell's g-value before setting the bit and
+//             reads the other side's g-value only after seeing its bit,
+//             and then it is final.
+//   best      the cheapest meeting found, packed as cost << 32 | cell so
+//             that it is lowered with a single compare-and-swap.
+//   radius    each side's current top key, to evaluate the stopping rule.
+//
+// Meetings are found when a side settles a cell or relaxes a move into a
+// cell the other side has settled. Settling sets the own bit before the
+// other side's bits are read, both sequentially consistent, so of two
+// sides settling the ends of a move at the same time at least one sees the
+// other. A side stops once its top key plus the other's radius reaches
+// `best`, or when the other side has stopped.
+//
+// The backward thread is started by the first query and waits for the
+// next one in between, so a query pays for waking it rather than for
+// starting a thread. That still takes microseconds, so this pays off on
+// long queries only. In the viewer the whole search runs in the first
+// step.
+template <typename OpenList, typename Movement, bool ASTAR>
+class BasicParallelBidirectionalSolver : public Solver {
+    static constexpr int FORWARD = 0;
+    static constexpr int BACKWARD = 1;
+    static constexpr int KEY_SCALE = ASTAR ? 2 : 1;
+    static constexpr std::uint64_t NO_MEETING = ~0ull;
+
+    OpenList open[2];
+    std::shared_ptr<SearchWorkspace> backward =
+        std::make_shared<SearchWorkspace>();
+    std::vector<std::atomic<std::uint64_t>> settled[2];
+    // words of `settled` set during the query, cleared after it
+    std::vector<std::size_t> dirty[2];
+    std::atomic<std::uint64_t> best{NO_MEETING};
+    std::atomic<long long> radius[2];
+    std::atomic<bool> stop{false};
+    std::size_t expanded[2] = {0, 0};
+    CellId source = NO_CELL;
+    CellId meet = NO_CELL;
+    bool done = false;
+
+    // the backward side's thread, parked between queries
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const GridMap *searched = nullptr;
+    std::uint64_t generation = 0;
+    bool running = false;
+    bool quit = false;
+
+    int calculateHeuristic(const GridMap &grid, CellId from, CellId to) {
+        return Movement::heuristic(
+            std::abs((int)grid.cellX(from) - (int)grid.cellX(to)),
+            std::abs((int)grid.cellY(from) - (int)grid.cellY(to)));
+    }
+    int potential(const GridMap &grid, CellId cell) {
+        if (!ASTAR) return 0;
+        return calculateHeuristic(grid, cell, target) -
+               calculateHeuristic(grid, cell, source);
+    }
+    SearchWorkspace &side(int s) { return s == FORWARD ? *workspace : *backward; }
+    bool isSettled(int s, CellId cell) const {
+        return settled[s][cell / 64].load() >> (cell % 64) & 1;
+    }
+    void settle(int s, CellId cell);
+    void offerMeeting(long long cost, CellId cell);
+    void run(const GridMap &grid, int s);
+    void search(const GridMap &grid);
+    void loop();
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+    bool pathFound(CellId) const override { return done; }
+    int buildPath(const GridMap &grid, CellId start, CellId goal,
+                  std::vector<CellId> &path) override;
+
+   public:
+    BasicParallelBidirectionalSolver() { straightCost = Movement::STRAIGHT; }
+    ~BasicParallelBidirectionalSolver() override;
+    SearchResult findPath(const GridMap &grid, CellId start,
+                          CellId goal) override;
+    std::string getName() override {
+        return std::string(ASTAR ? "Parallel Bidirectional A* Solver"
+                                 : "Parallel Bidirectional Dijkstra Solver") +
+               Movement::SUFFIX;
+    }
+};
+
+template <typename OpenList, typename Movement = FourConnected>
+using BasicParallelBidirectionalAStarSolver =
+    BasicParallelBidirectionalSolver<OpenList, Movement, true>;
+template <typename OpenList, typename Movement = FourConnected>
+using BasicParallelBidirectionalDijkstraSolver =
+    BasicParallelBidirectionalSolver<OpenList, Movement, false>;
+
+using ParallelBidirectionalAStarSolver =
+    BasicParallelBidirectionalAStarSolver<QuaternaryHeap>;
+using ParallelBidirectionalDijkstraSolver =
+    BasicParallelBidirectionalDijkstraSolver<BucketQueue>;
+
+#endif
@@ -0,0 +1,225 @@
+#include "path_database.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "grid_map.hpp"
+#include "movement.hpp"
+
+namespace {
+
+constexpr std::uint32_t UNREACHABLE = UINT32_MAX;
+// Move of the source itself and of the cells it cannot reach.
+constexpr std::uint32_t NO_MOVE = 4;
+constexpr int MOVE_BITS = 3;
+constexpr std::uint64_t MAX_CELLS = std::uint64_t(1) << (32 - MOVE_BITS);
+
+// Calls f(i, thread) for i in [0, count) on all hardware threads.
+template <typename F>
+void parallelFor(std::size_t count, F f) {
+    std::atomic<std::size_t> next{0};
+    auto work = [&](unsigned thread) {
+        for (std::size_t i; (i = next++) < count;) f(i, thread);
+    };
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount && t < count; t++)
+        threads.emplace_back(work, t);
+    work(0);
+    for (std::thread &thread : threads) thread.join();
+}
+
+// Scratch space of one thread's builds.
+struct Builder {
+    std::vector<std::uint32_t> dist;
+    std::vector<std::vector<CellId>> buckets;
+
+    // Dijkstra from `source` over the whole map. Moves cost less than
+    // `ring`, so the open cells fit in a ring of that many buckets
+    // (Dial's algorithm).
+    void flood(const GridMap &grid, CellId source, int ring) {
+        dist.assign(grid.size(), UNREACHABLE);
+        buckets.resize(ring);
+        dist[source] = 0;
+        buckets[0].push_back(source);
+        std::size_t queued = 1;
+        for (std::uint32_t cost = 0; queued > 0; cost++) {
+            std::vector<CellId> &bucket = buckets[cost % ring];
+            queued -= bucket.size();
+            for (CellId cell : bucket) {
+                if (dist[cell] != cost) continue;
+                int x = grid.cellX(cell);
+                int y = grid.cellY(cell);
+                std::uint32_t newCost = cost + grid.cost(cell);
+                forEachMove<FourConnected>([&](const Move &move) {
+                    int nx = x + move.dx;
+                    int ny = y + move.dy;
+                    if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m)
+                        return;
+                    CellId next = grid.index(nx, ny);
+                    if (!grid.passable[next] || newCost >= dist[next]) return;
+                    dist[next] = newCost;
+                    buckets[newCost % ring].push_back(next);
+                    queued++;
+                });
+            }
+            bucket.clear();
+        }
+    }
+
+    // The runs of `source`'s row, and for every block of cells the index
+    // of the last run starting at or before its first cell.
+    void buildRow(const GridMap &grid, CellId source, int ring,
+                  std::vector<std::uint32_t> &row,
+                  std::vector<std::uint32_t> &blockRun) {
+        flood(grid, source, ring);
+        row.clear();
+        std::uint32_t previous = NO_MOVE;
+        for (int y = 0; y < grid.m; y++) {
+            for (int x = 0; x < grid.n; x++) {
+                CellId cell = grid.index(x, y);
+                if (!grid.passable[cell]) continue;
+                std::uint32_t move = NO_MOVE;
+                if (cell != source && dist[cell] != UNREACHABLE) {
+                    // any cheapest parent will do, prefer the previous
+                    // cell's move
+                    for (std::uint32_t i = 0; i < 4; i++) {
+                        const Move &m = FourConnected::moves[i];
+                        int px = x - m.dx;
+                        int py = y - m.dy;
+                        if (px < 0 || px >= grid.n || py < 0 || py >= grid.m)
+                            continue;
+                        CellId parent = grid.index(px, py);
+                        if (!grid.passable[parent] ||
+                            dist[parent] == UNREACHABLE ||
+                            dist[parent] + grid.cost(parent) != dist[cell])
+                            continue;
+                        if (move == NO_MOVE || i == previous) move = i;
+                        if (i == previous) break;
+                    }
+                }
+                if (row.empty() || move != previous)
+                    row.push_back(cell << MOVE_BITS | move);
+                previous = move;
+            }
+        }
+        std::size_t blocks =
+            (grid.size() + PathDatabase::BLOCK - 1) / PathDatabase::BLOCK;
+        blockRun.assign(blocks, 0);
+        std::uint32_t run = 0;
+        for (std::size_t b = 0; b < blocks; b++) {
+            CellId first = b * PathDatabase::BLOCK;
+            while (run + 1 < row.size() && row[run + 1] >> MOVE_BITS <= first)
+                run++;
+            blockRun[b] = run;
+        }
+    }
+};
+
+}  // namespace
+
+PathDatabase PathDatabase::build(const GridMap &grid,
+                                 const std::vector<Region> &regions) {
+    PathDatabase db;
+    db.n = grid.n;
+    db.m = grid.m;
+    if ((std::uint64_t)grid.size() >= MAX_CELLS) return db;
+    for (const Region &r : regions) {
+        for (int y = std::max(r.y0, 0); y < std::min(r.y1, grid.m); y++) {
+            for (int x = std::max(r.x0, 0); x < std::min(r.x1, grid.n); x++) {
+                CellId cell = grid.index(x, y);
+                if (grid.passable[cell]) db.sources.push_back(cell);
+            }
+        }
+    }
+    std::sort(db.sources.begin(), db.sources.end());
+    db.sources.erase(std::unique(db.sources.begin(), db.sources.end()),
+                     db.sources.end());
+
+    int ring = 1;
+    for (int cell = 0; cell < grid.size(); cell++) {
+        if (grid.passable[cell]) ring = std::max(ring, grid.cost(cell) + 1);
+    }
+    std::size_t count = db.sources.size();
+    std::vector<std::vector<std::uint32_t>> rows(count);
+    std::vector<std::vector<std::uint32_t>> blockRuns(count);
+    std::vector<Builder> builders(
+        std::max(1u, std::thread::hardware_concurrency()));
+    parallelFor(count, [&](std::size_t i, unsigned thread) {
+        builders[thread].buildRow(grid, db.sources[i], ring, rows[i],
+                                  blockRuns[i]);
+    });
+
+    std::uint64_t total = 0;
+    for (const std::vector<std::uint32_t> &row : rows) total += row.size();
+    if (total > UINT32_MAX) {
+        db.sources.clear();
+        return db;
+    }
+    db.blocks = (grid.size() + BLOCK - 1) / BLOCK;
+    db.firstRun.assign(1, 0);
+    db.runs.reserve(total);
+    db.blockRun.reserve(count * db.blocks);
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint32_t offset = db.runs.size();
+        for (std::uint32_t run : blockRuns[i])
+            db.blockRun.push_back(offset + run);
+        db.runs.insert(db.runs.end(), rows[i].begin(), rows[i].end());
+        db.firstRun.push_back(db.runs.size());
+        std::vector<std::uint32_t>().swap(rows[i]);
+        std::vector<std::uint32_t>().swap(blockRuns[i]);
+    }
+    return db;
+}
+
+int PathDatabase::row(CellId source) const {
+    auto it = std::lower_bound(sources.begin(), sources.end(), source);
+    if (it == sources.end() || *it != source) return -1;
+    return it - sources.begin();
+}
+
+bool PathDatabase::covers(const GridMap &grid, CellId source) const {
+    return n == grid.n && m == grid.m && row(source) >= 0;
+}
+
+bool PathDatabase::findPath(const GridMap &grid, CellId source, CellId goal,
+                            std::vector<CellId> &path) const {
+    path.clear();
+    if (!grid.passable[goal]) return false;
+    int r = row(source);
+    const std::uint32_t *end = runs.data() + firstRun[r + 1];
+    const std::uint32_t *index = blockRun.data() + r * blocks;
+    CellId cell = goal;
+    // a path visits no cell twice
+    for (int steps = 0; steps < grid.size(); steps++) {
+        path.push_back(cell);
+        if (cell == source) {
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+        // the last run starting at or before `cell` is among those from
+        // the one covering its block to the one covering the next block
+        std::size_t b = cell >> BLOCK_BITS;
+        const std::uint32_t *first = runs.data() + index[b];
+        const std::uint32_t *last =
+            b + 1 < blocks ? runs.data() + index[b + 1] + 1 : end;
+        const std::uint32_t *run = std::upper_bound(
+            first, last, cell, [](CellId c, std::uint32_t run) {
+                return c < run >> MOVE_BITS;
+            });
+        if (run == first) break;
+        std::uint32_t move = run[-1] & ((1u << MOVE_BITS) - 1);
+        if (move == NO_MOVE) break;
+        const Move &m = FourConnected::moves[move];
+        cell = grid.index(grid.cellX(cell) - m.dx, grid.cellY(cell) - m.dy);
+    }
+    path.clear();
+    return false;
+}
+
+std::size_t PathDatabase::bytes() const {
+    return (sources.size() + firstRun.size() + runs.size() +
+            blockRun.size()) *
+           sizeof(std::uint32_t);
+}
@@ -0,0 +1,75 @@
+#ifndef PATH_DATABASE_HPP
+#define PATH_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils.hpp"
+
+struct GridMap;
+
+// Compressed path database for the 4-connected grid: paths from a few
+// source regions to anywhere, answered by table lookups alone (see
+// cpd_solver.hpp). Every source cell gets a row holding, for every cell
+// of the map in row-major order, the move by which a cheapest path from
+// the source enters it. A path is read backwards from the goal, one
+// lookup in the source's row per cell, so only the sources need rows.
+//
+// Shortest path trees change direction rarely along a row of cells, so a
+// row is stored as runs of equal moves: each run is its first cell and
+// its move packed in 32 bits. Walls are never looked up and join whichever
+// run they fall in. Ties between cheapest parents are broken towards the
+// move the previous cell of the row got, which keeps the runs long.
+//
+// Each row also indexes the run covering the first cell of every block of
+// BLOCK cells, so a lookup is a binary search over the runs starting in
+// one block, at most log2(BLOCK) steps, and a path of L cells takes O(L)
+// time. The index adds 4 bytes per BLOCK cells to every row.
+//
+// Runs pack a cell id into 29 bits, so maps of 2^29 cells or more get an
+// empty database, as do ones whose runs would not fit a 32-bit index.
+//
+// Rows are built on all hardware threads, one Dijkstra per source.
+class PathDatabase {
+   public:
+    struct Region {
+        int x0, y0, x1, y1;  // cells [x0, x1) x [y0, y1)
+    };
+
+    static constexpr int BLOCK_BITS = 8;
+    static constexpr std::size_t BLOCK = std::size_t(1) << BLOCK_BITS;
+
+   private:
+    int n = 0;
+    int m = 0;
+    // Source cells, sorted, and where each one's runs start.
+    std::vector<CellId> sources;
+    std::vector<std::uint32_t> firstRun;
+    std::vector<std::uint32_t> runs;
+    // blockRun[row * blocks + b] is the index in `runs` of the last run of
+    // the row starting at or before cell b * BLOCK.
+    std::size_t blocks = 0;
+    std::vector<std::uint32_t> blockRun;
+
+    int row(CellId source) const;
+
+   public:
+    static PathDatabase build(const GridMap &grid,
+                              const std::vector<Region> &regions);
+
+    // Whether `source` has a row and the database was built for a map of
+    // the dimensions of `grid`. The terrain is assumed unchanged.
+    bool covers(const GridMap &grid, CellId source) const;
+    // Writes the cells of a cheapest path from `source` to `goal` into
+    // `path`, in O(path length) time. False if `goal` cannot be reached.
+    // `source` must be covered.
+    bool findPath(const GridMap &grid, CellId source, CellId goal,
+                  std::vector<CellId> &path) const;
+
+    std::size_t sourceCount() const { return sources.size(); }
+    std::size_t runCount() const { return runs.size(); }
+    std::size_t bytes() const;
+};
+
+#endif
@@ -1,66 +1,62 @@
 #include "problem.hpp"
 
-Problem::Problem(int n, int m) {
-    this->n = n;
-    this->m = m;
-    grid.resize(n);
-    for (unsigned int x = 0; x < n; x++) {
-        grid[x].reserve(m);
-        for (unsigned int y = 0; y < m; y++) {
-            grid[x].push_back(Cell(x, y));
-        }
-    }
-    solution = {};
-    start = nullptr;
-    goal = nullptr;
+Problem::Problem(int n, int m) : maps(GridMap(n, m)) {
+    state.restart(maps.edit().size());
 }
 
-void Problem::clearSolution() { solution = {}; };
+void Problem::clearSolution() { state.solution = {}; };
+
+void Problem::setTerrain(CellId id, CellType type) {
+    GridMap &map = maps.edit();
+    if (map.type(id) == type) return;
+    map.setTerrain(id, type);
+    maps.publish();
+}
 
 void Problem::setCell(unsigned int x, unsigned int y, DrawMode mode) {
+    const GridMap &map = maps.edit();
+    CellId id = map.index(x, y);
     switch (mode) {
         case DrawMode::WALL:
-            grid[x][y].type = CellType::WALL;
+            setTerrain(id, CellType::WALL);
             break;
         case DrawMode::FOREST:
-            grid[x][y].type = CellType::FOREST;
+            setTerrain(id, CellType::FOREST);
             break;
         case DrawMode::WATER:
-            grid[x][y].type = CellType::WATER;
+            setTerrain(id, CellType::WATER);
             break;
         case DrawMode::PATH_GOAL:
-            if (grid[x][y].type == CellType::WALL ||
-                (start && start->x == x && start->y == y))
-                break;
-            goal = &grid[x][y];
+            if (!map.passable[id] || state.start == id) break;
+            state.goal = id;
             break;
         case DrawMode::PATH_START:
-            if (grid[x][y].type == CellType::WALL ||
-                (goal && goal->x == x && goal->y == y))
-                break;
-            start = &grid[x][y];
+            if (!map.passable[id] || state.goal == id) break;
+            state.start = id;
             break;
         default:
-            grid[x][y].type = CellType::CLEAR;
+            setTerrain(id, CellType::CLEAR);
             break;
     }
 };
 
 void Problem::clearCell(unsigned int x, unsigned int y) {
-    grid[x][y].type = CellType::CLEAR;
-    if (start && start->x == x && start->y == y) {
-        start = nullptr;
+    CellId id = maps.edit().index(x, y);
+    setTerrain(id, CellType::CLEAR);
+    if (state.start == id) {
+        state.start = NO_CELL;
     }
-    if (goal && goal->x == x && goal->y == y) {
-        goal = nullptr;
+    if (state.goal == id) {
+        state.goal = NO_CELL;
     }
 };
 
-void Problem::restart() {
-    solution.clear();
-    for (int x = 0; x < n; x++) {
-        for (int y = 0; y < m; y++) {
-            grid[x][y].visited = false;
-        }
-    }
-};
\ No newline at end of file
+void Problem::restart() { state.restart(maps.edit().size()); };
+
+void Problem::clear() {
+    GridMap &map = maps.edit();
+    map = GridMap(map.n, map.m);
+    maps.publish();
+    state = SearchState();
+    restart();
+}
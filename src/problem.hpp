@@ -1,23 +1,34 @@
 #ifndef PROBLEM_HPP
 #define PROBLEM_HPP
 
-#include <vector>
+#include <memory>
 
+#include "grid_map.hpp"
+#include "map_store.hpp"
+#include "search_state.hpp"
 #include "utils.hpp"
 
+// What the viewer edits: a map and the interactive query on it. Drawing
+// the start or the goal changes the query, anything else publishes a new
+// version of the map, so a search running on an older one is unaffected.
 struct Problem {
-    int n;
-    int m;
-    std::vector<std::vector<Cell>> grid;
-    std::vector<Cell*> solution;
-    Cell* start;
-    Cell* goal;
+    MapStore maps;
+    SearchState state;
 
     Problem(int n, int m);
+
+    // The current version of the map.
+    std::shared_ptr<const GridMap> map() const { return maps.snapshot(); }
+
     void clearSolution();
     void setCell(unsigned int x, unsigned int y, DrawMode mode);
     void clearCell(unsigned int x, unsigned int y);
     void restart();
+    // Replaces the map with an empty one and forgets the query.
+    void clear();
+
+   private:
+    void setTerrain(CellId id, CellType type);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,31 @@
+#ifndef COLORS_HPP
+#define COLORS_HPP
+
+#include <glm/glm.hpp>
+#include "../utils.hpp"
+
+constexpr glm::vec4 getCellColor(CellType type, bool visited) {
+    glm::vec4 col;
+    switch (type) {
+        case CellType::CLEAR:
+            col = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+            break;
+        case CellType::FOREST:
+            col = glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+            break;
+        case CellType::WATER:
+            col = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+            break;
+        case CellType::WALL:
+            col = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            break;
+        default:
+            col = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            break;
+    }
+    if (visited)
+        col = glm::mix(col, glm::vec4(0.5f, 0.5f, 0.5f, 1.0f), 0.5f);
+    return col;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "scenario.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+
+double pathLength(const GridMap &grid, const std::vector<CellId> &path) {
+    double length = 0.0;
+    for (std::size_t i = 1; i < path.size(); i++) {
+        int dx = (int)grid.cellX(path[i]) - (int)grid.cellX(path[i - 1]);
+        int dy = (int)grid.cellY(path[i]) - (int)grid.cellY(path[i - 1]);
+        length += std::sqrt(double(dx * dx + dy * dy));
+    }
+    return length;
+}
+
+ScenarioReport runScenario(Solver &solver, const GridMap &grid,
+                           const std::vector<ScenarioEntry> &entries,
+                           double tolerance) {
+    ScenarioReport report;
+    std::map<int, BucketStats> buckets;
+    for (const ScenarioEntry &e : entries) {
+        if (e.startX >= (unsigned)grid.n || e.goalX >= (unsigned)grid.n ||
+            e.startY >= (unsigned)grid.m || e.goalY >= (unsigned)grid.m) {
+            report.skipped++;
+            continue;
+        }
+        CellId start = grid.index(e.startX, e.startY);
+        CellId goal = grid.index(e.goalX, e.goalY);
+        if (!grid.passable[start] || !grid.passable[goal]) {
+            report.skipped++;
+            continue;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        SearchResult result = solver.findPath(grid, start, goal);
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count();
+
+        BucketStats &stats = buckets[e.bucket];
+        stats.bucket = e.bucket;
+        stats.queries++;
+        stats.seconds += seconds;
+        stats.expansions += result.expansions;
+        report.queries++;
+        report.seconds += seconds;
+        if (!result.found) {
+            stats.failed++;
+            report.failed++;
+            continue;
+        }
+        double length = pathLength(grid, result.path);
+        if (std::abs(length - e.optimalLength) >
+            tolerance * std::max(1.0, e.optimalLength)) {
+            stats.mismatched++;
+            report.mismatched++;
+        }
+    }
+    for (auto &[bucket, stats] : buckets) report.buckets.push_back(stats);
+    return report;
+}
@@ -0,0 +1,41 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "grid_map.hpp"
+#include "movingai.hpp"
+#include "solver.hpp"
+
+struct BucketStats {
+    int bucket = 0;
+    int queries = 0;
+    int failed = 0;      // no path found
+    int mismatched = 0;  // path length differs from the reference
+    double seconds = 0.0;
+    std::size_t expansions = 0;
+};
+
+struct ScenarioReport {
+    std::vector<BucketStats> buckets;  // sorted by bucket
+    int queries = 0;
+    int failed = 0;
+    int mismatched = 0;
+    int skipped = 0;  // entries outside the map or on a wall
+    double seconds = 0.0;
+};
+
+// Geometric length of a path: 1 per orthogonal step, the Euclidean distance
+// for anything else. This is what .scen files record as the optimal length.
+double pathLength(const GridMap &grid, const std::vector<CellId> &path);
+
+// Runs every scenario entry through the solver and compares the length of
+// the returned path with the recorded optimal length. Recorded lengths are
+// octile, so only solvers using the EightConnected movement model can
+// match them.
+ScenarioReport runScenario(Solver &solver, const GridMap &grid,
+                           const std::vector<ScenarioEntry> &entries,
+                           double tolerance = 1e-4);
+
+#endif
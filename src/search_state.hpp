@@ -0,0 +1,27 @@
+#ifndef SEARCH_STATE_HPP
+#define SEARCH_STATE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "epoch.hpp"
+#include "utils.hpp"
+
+// The interactive query on a map: its ends, the cells expanded so far and
+// the path found, as shown by the viewer. Visited flags live in an
+// epoch-stamped bitset, so restart() is O(1). Solvers keep the rest of
+// their search state in a SearchWorkspace.
+struct SearchState {
+    CellId start = NO_CELL;
+    CellId goal = NO_CELL;
+    EpochBitset visited;
+    std::vector<CellId> solution;
+
+    // Forgets the last search, on a map with `cells` cells.
+    void restart(std::size_t cells) {
+        solution.clear();
+        visited.prepare(cells);
+    }
+};
+
+#endif
@@ -1,167 +1,183 @@
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 
 #include "solver.hpp"
 
-void AStarSolver::solve(Problem& problem) {
+void Solver::solve(const GridMap& grid, SearchState& state) {
     if (this->solved || this->solving) {
         std::cout << "Already solving a problem..." << std::endl;
         return;
     }
-    std::cout << "Solving problem with A* algorithm..." << std::endl;
-    std::printf("Start: (%u, %u). Goal: (%u, %u)\n", problem.start->x,
-                problem.start->y, problem.goal->x, problem.goal->y);
-    if (!problem.start || !problem.goal) {
+    if (state.start == NO_CELL || state.goal == NO_CELL) {
         std::cout << "Start or goal not set!" << std::endl;
         return;
     }
-    problem.restart();
-    std::priority_queue<std::pair<int, Cell*>,
-                        std::vector<std::pair<int, Cell*>>, Compare>
-        newQ;
-    std::swap(queue, newQ);
-
-    cost = std::vector<std::vector<int>>(problem.n,
-                                         std::vector<int>(problem.m, INT_MAX));
-    cost[problem.start->x][problem.start->y] = 0;
-
-    fValues = std::vector<std::vector<int>>(problem.n,
-                                            std::vector<int>(problem.m, -1));
-    fValues[problem.start->x][problem.start->y] = 0;
-
-    parent = std::vector<std::vector<Cell*>>(
-        problem.n, std::vector<Cell*>(problem.m, nullptr));
-
-    queue.push({0, problem.start});
+    if (!grid.passable[state.start] || !grid.passable[state.goal]) {
+        std::cout << "Start or goal is a wall!" << std::endl;
+        return;
+    }
+    std::cout << "Solving problem with " << getName() << "..." << std::endl;
+    std::printf("Start: (%u, %u). Goal: (%u, %u)\n",
+                grid.cellX(state.start), grid.cellY(state.start),
+                grid.cellX(state.goal), grid.cellY(state.goal));
+    state.restart(grid.size());
+    startSearch(grid, state.start, state.goal);
     solving = true;
 }
 
-int AStarSolver::stepSolve(Problem& problem) {
+int Solver::stepSolve(const GridMap& grid, SearchState& state) {
     if (!solving) {
         std::cout << "Hasn't started solving yet" << std::endl;
         return 0;
     }
     // found the solution during previous steps
     if (solved) {
-        Cell* cell = problem.goal;
-        int totalCost = 0;
-        while (cell != problem.start) {
-            problem.solution.push_back(cell);
-            totalCost += static_cast<int>(cell->type);
-            Cell* p = parent[cell->x][cell->y];
-            cell = p;
-        }
-        totalCost += static_cast<int>(cell->type);
-        problem.solution.push_back(cell);
-        std::reverse(problem.solution.begin(), problem.solution.end());
+        int totalCost =
+            buildPath(grid, state.start, state.goal, state.solution);
         std::cout << "Solution found!" << std::endl;
-        solved = true;
         solving = false;
         return totalCost;
     }
-    auto a = queue.top();
-    Cell* cell = a.second;
-    queue.pop();
-    cell->visited = true;
+    CellId cell = expandNext(grid);
+    if (cell == NO_CELL) {
+        std::cout << "No path found!" << std::endl;
+        solving = false;
+        return -1;
+    }
+    state.visited.set(cell);
     // Found the goal, next step will build the solution
-    if (cell == problem.goal) {
+    if (pathFound(cell)) {
         solved = true;
-        return 0;
-    }
-    int x = cell->x;
-    int y = cell->y;
-    for (auto [dx, dy] : directions) {
-        int nx = x + dx;
-        int ny = y + dy;
-        if (nx < 0 || nx >= problem.n || ny < 0 || ny >= problem.m) continue;
-        int newCost = cost[x][y] + static_cast<int>(problem.grid[x][y].type);
-        int heur = calculateHeuristic(problem.goal, nx, ny);
-        int fVal = newCost + heur;
-        if (fValues[nx][ny] == -1 || fValues[nx][ny] > fVal) {
-            cost[nx][ny] = newCost;
-            fValues[nx][ny] = fVal;
-            parent[nx][ny] = cell;
-            queue.push({fVal, &problem.grid[nx][ny]});
-        }
     }
     return 0;
-};
+}
 
-void DijkstraSolver::solve(Problem& problem) {
-    if (this->solved || this->solving) {
-        std::cout << "Already solving a problem..." << std::endl;
-        return;
-    }
-    std::cout << "Solving problem with Dijkstra algorithm..." << std::endl;
-    std::printf("Start: (%u, %u). Goal: (%u, %u)\n", problem.start->x,
-                problem.start->y, problem.goal->x, problem.goal->y);
-    if (!problem.start || !problem.goal) {
-        std::cout << "Start or goal not set!" << std::endl;
-        return;
+SearchResult Solver::findPath(const GridMap& grid, CellId start,
+                              CellId goal) {
+    SearchResult result;
+    if (start == NO_CELL || goal == NO_CELL) return result;
+    if (!grid.passable[start] || !grid.passable[goal]) return result;
+    startSearch(grid, start, goal);
+    CellId cell;
+    do {
+        cell = expandNext(grid);
+        if (cell == NO_CELL) return result;
+        result.expansions++;
+    } while (!pathFound(cell));
+    result.found = true;
+    result.cost = buildPath(grid, start, goal, result.path);
+    return result;
+}
+
+int Solver::buildPath(const GridMap& grid, CellId start, CellId goal,
+                      std::vector<CellId>& path) {
+    SearchWorkspace& ws = *workspace;
+    path.clear();
+    CellId cell = goal;
+    while (cell != start) {
+        path.push_back(cell);
+        cell = ws.parent[cell];
     }
-    problem.restart();
-    std::priority_queue<std::pair<int, Cell*>,
-                        std::vector<std::pair<int, Cell*>>, Compare>
-        newQ;
-    std::swap(queue, newQ);
+    path.push_back(cell);
+    std::reverse(path.begin(), path.end());
+    return ws.cost[goal] + grid.cost(goal) * straightCost;
+}
 
-    cost = std::vector<std::vector<int>>(problem.n,
-                                         std::vector<int>(problem.m, INT_MAX));
-    cost[problem.start->x][problem.start->y] = 0;
+template <typename OpenList, typename Movement>
+void BasicAStarSolver<OpenList, Movement>::startSearch(const GridMap& grid,
+                                             CellId start, CellId goal) {
+    target = goal;
+    SearchWorkspace& ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    ws.cost.set(start, 0);
+    open.push(start, 0);
+}
 
-    parent = std::vector<std::vector<Cell*>>(
-        problem.n, std::vector<Cell*>(problem.m, nullptr));
+template <typename OpenList, typename Movement>
+CellId BasicAStarSolver<OpenList, Movement>::expandNext(const GridMap& grid) {
+    SearchWorkspace& ws = *workspace;
+    CellId cell;
+    // skip entries of cells that were already expanded
+    do {
+        if (open.empty()) return NO_CELL;
+        cell = open.pop().second;
+    } while (ws.closed.test(cell));
+    ws.closed.set(cell);
+    if (cell == target) return cell;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int cost = ws.cost[cell];
+    int leaving = grid.cost(cell);
+    forEachMove<Movement>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next]) return;
+        if (!Movement::allowed(grid, x, y, move)) return;
+        int newCost = cost + leaving * move.cost;
+        if (ws.closed.test(next) || newCost >= ws.cost[next]) return;
+        ws.cost.set(next, newCost);
+        ws.parent.set(next, cell);
+        open.push(next, newCost + calculateHeuristic(grid, nx, ny));
+    });
+    return cell;
+};
 
-    queue.push({0, problem.start});
-    solving = true;
+template <typename OpenList, typename Movement>
+void BasicDijkstraSolver<OpenList, Movement>::startSearch(const GridMap& grid,
+                                                CellId start, CellId goal) {
+    target = goal;
+    SearchWorkspace& ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    ws.cost.set(start, 0);
+    open.push(start, 0);
 }
 
-int DijkstraSolver::stepSolve(Problem& problem) {
-    if (!solving) {
-        std::cout << "Hasn't started solving yet" << std::endl;
-        return 0;
-    }
-    // found the solution during previous steps
-    if (solved) {
-        Cell* cell = problem.goal;
-        int totalCost = 0;
-        while (cell != problem.start) {
-            problem.solution.push_back(cell);
-            totalCost += static_cast<int>(cell->type);
-            Cell* p = parent[cell->x][cell->y];
-            cell = p;
-        }
-        totalCost += static_cast<int>(cell->type);
-        problem.solution.push_back(cell);
-        std::reverse(problem.solution.begin(), problem.solution.end());
-        std::cout << "Solution found!" << std::endl;
-        solved = true;
-        solving = false;
-        return totalCost;
-    }
-    auto a = queue.top();
-    Cell* cell = a.second;
-    cell->visited = true;
-    int cellCost = a.first;
-    queue.pop();
-    if (cell == problem.goal) {
-        solved = true;
-        return 0;
-    }
+template <typename OpenList, typename Movement>
+CellId BasicDijkstraSolver<OpenList, Movement>::expandNext(const GridMap& grid) {
+    SearchWorkspace& ws = *workspace;
+    CellId cell;
+    do {
+        if (open.empty()) return NO_CELL;
+        cell = open.pop().second;
+    } while (ws.closed.test(cell));
+    ws.closed.set(cell);
+    if (cell == target) return cell;
 
-    int x = cell->x;
-    int y = cell->y;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int cost = ws.cost[cell];
+    int leaving = grid.cost(cell);
 
-    for (auto [dx, dy] : directions) {
-        int nx = x + dx;
-        int ny = y + dy;
-        if (nx < 0 || nx >= problem.n || ny < 0 || ny >= problem.m) continue;
-        int newCost = cellCost + static_cast<int>(cell->type);
-        if (newCost < cost[nx][ny]) {
-            cost[nx][ny] = newCost;
-            parent[nx][ny] = cell;
-            queue.push({newCost, &problem.grid[nx][ny]});
-        }
-    }
-    return 0;
-};
\ No newline at end of file
+    forEachMove<Movement>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next]) return;
+        if (!Movement::allowed(grid, x, y, move)) return;
+        int newCost = cost + leaving * move.cost;
+        if (ws.closed.test(next) || newCost >= ws.cost[next]) return;
+        ws.cost.set(next, newCost);
+        ws.parent.set(next, cell);
+        open.push(next, newCost);
+    });
+    return cell;
+};
+
+template class BasicAStarSolver<LazyBinaryHeap>;
+template class BasicAStarSolver<BinaryHeap>;
+template class BasicAStarSolver<QuaternaryHeap>;
+template class BasicAStarSolver<BucketQueue>;
+template class BasicDijkstraSolver<LazyBinaryHeap>;
+template class BasicDijkstraSolver<BinaryHeap>;
+template class BasicDijkstraSolver<QuaternaryHeap>;
+template class BasicDijkstraSolver<BucketQueue>;
+template class BasicAStarSolver<QuaternaryHeap, EightConnected>;
+template class BasicAStarSolver<QuaternaryHeap, EightConnectedCutting>;
+template class BasicDijkstraSolver<BucketQueue, EightConnected>;
+template class BasicDijkstraSolver<BucketQueue, EightConnectedCutting>;
@@ -1,22 +1,50 @@
 #ifndef SOLVER_HPP
 #define SOLVER_HPP
 
-#include "problem.hpp"
+#include "grid_map.hpp"
+#include "movement.hpp"
+#include "open_list.hpp"
+#include "search_state.hpp"
 #include "utils.hpp"
+#include "workspace.hpp"
+#include <cstddef>
+#include <memory>
 #include <string>
-#include <queue>
+#include <vector>
 
-struct Compare {
-    bool operator()(const std::pair<int, Cell *> &a,
-                    const std::pair<int, Cell *> &b) const {
-        return a.first > b.first;
-    }
+struct SearchResult {
+    bool found = false;
+    std::vector<CellId> path;
+    int cost = 0;
+    std::size_t expansions = 0;
 };
 
 class Solver {
    protected:
-    std::vector<std::pair<int, int>> directions = {
-        {0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+    // Step cost of an orthogonal move in the solver's movement model, see
+    // movement.hpp.
+    int straightCost = 1;
+    std::shared_ptr<SearchWorkspace> workspace =
+        std::make_shared<SearchWorkspace>();
+    CellId target = NO_CELL;
+
+    // Search hooks shared by the interactive (solve/stepSolve) and the
+    // headless (findPath) drivers. They only read the map and print
+    // nothing.
+    virtual void startSearch(const GridMap &grid, CellId start,
+                             CellId goal) = 0;
+    // Pops the next cell from the open list and expands it, unless it is
+    // the goal. Returns the popped cell, or NO_CELL once the open list is
+    // exhausted.
+    virtual CellId expandNext(const GridMap &grid) = 0;
+    // Whether the search is complete after expandNext() returned `cell`.
+    virtual bool pathFound(CellId cell) const { return cell == target; }
+    // Writes the start..goal path into `path` and returns its cost: the
+    // cost of every move on it plus the goal's terrain cost as if it were
+    // left by a straight move. With 4-connected moves that is the sum of
+    // the terrain costs of every cell on it.
+    virtual int buildPath(const GridMap &grid, CellId start, CellId goal,
+                          std::vector<CellId> &path);
 
    public:
     bool solved = false;
@@ -24,40 +52,69 @@ class Solver {
     double lastStepTime = 0.0;
 
     virtual ~Solver() = default;
-    virtual void solve(Problem &problem) = 0;
-    virtual int stepSolve(Problem &problem) = 0;
+    // Starts the interactive search for `state`'s query. The map must not
+    // change until the search is over.
+    virtual void solve(const GridMap &grid, SearchState &state);
+    // Advances the interactive search by one expansion, marking the
+    // expanded cell in `state`. Returns the path cost once the solution is
+    // built, -1 if the goal is unreachable and 0 otherwise.
+    virtual int stepSolve(const GridMap &grid, SearchState &state);
     virtual std::string getName() = 0;
+
+    // Runs a query to completion without touching `grid` or printing.
+    // `found` is false if the goal is unreachable or either end is a wall.
+    // Must not be called while an interactive solve is in progress.
+    virtual SearchResult findPath(const GridMap &grid, CellId start,
+                                  CellId goal);
+
+    // Replaces the solver's search storage, e.g. with
+    // SearchWorkspace::forThread(). Must not be called while solving.
+    void setWorkspace(std::shared_ptr<SearchWorkspace> ws) {
+        workspace = std::move(ws);
+    }
+    SearchWorkspace &getWorkspace() { return *workspace; }
 };
 
-class AStarSolver : public Solver {
-    int calculateHeuristic(Cell *goal, int x, int y) {
-        return std::abs(x - (int)goal->x) + std::abs(y - (int)goal->y);
+// The solvers are instantiated for the open lists in open_list.hpp, see the
+// explicit instantiations at the end of solver.cpp.
+template <typename OpenList, typename Movement = FourConnected>
+class BasicAStarSolver : public Solver {
+    OpenList open;
+
+    int calculateHeuristic(const GridMap &grid, int x, int y) {
+        return Movement::heuristic(std::abs(x - (int)grid.cellX(target)),
+                                   std::abs(y - (int)grid.cellY(target)));
     };
 
-    std::priority_queue<std::pair<int, Cell *>,
-                        std::vector<std::pair<int, Cell *>>, Compare>
-        queue;
-    std::vector<std::vector<int>> cost;
-    std::vector<std::vector<int>> fValues;
-    std::vector<std::vector<Cell *>> parent;
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
 
    public:
-    void solve(Problem &problem) override;
-    int stepSolve(Problem &problem) override;
-    std::string getName() override { return "A* Solver"; }
+    BasicAStarSolver() { straightCost = Movement::STRAIGHT; }
+    std::string getName() override {
+        return std::string("A* Solver") + Movement::SUFFIX;
+    }
 };
 
-class DijkstraSolver : public Solver {
-    std::priority_queue<std::pair<int, Cell *>,
-                        std::vector<std::pair<int, Cell *>>, Compare>
-        queue;
-    std::vector<std::vector<int>> cost;
-    std::vector<std::vector<Cell *>> parent;
+template <typename OpenList, typename Movement = FourConnected>
+class BasicDijkstraSolver : public Solver {
+    OpenList open;
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
 
    public:
-    void solve(Problem &problem) override;
-    int stepSolve(Problem &problem) override;
-    std::string getName() override { return "Dijkstra Solver"; }
+    BasicDijkstraSolver() { straightCost = Movement::STRAIGHT; }
+    std::string getName() override {
+        return std::string("Dijkstra Solver") + Movement::SUFFIX;
+    }
 };
 
-#endif  // SOLVER_HPP
\ No newline at end of file
+using AStarSolver = BasicAStarSolver<QuaternaryHeap>;
+using DijkstraSolver = BasicDijkstraSolver<BucketQueue>;
+
+#endif  // SOLVER_HPP
@@ -0,0 +1,129 @@
+#include "theta_star.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include "line_of_sight.hpp"
+
+// Cost of moving to an adjacent cell; a diagonal also covers the two cells
+// beside it.
+static int stepCost(const GridMap &grid, CellId from, int x, int y,
+                    const Move &move) {
+    int cost = grid.cost(from);
+    if (move.dx != 0 && move.dy != 0)
+        cost = std::max({cost, grid.cost(grid.index(x + move.dx, y)),
+                         grid.cost(grid.index(x, y + move.dy))});
+    return cost * move.cost;
+}
+
+template <bool LAZY>
+void BasicThetaStarSolver<LAZY>::startSearch(const GridMap &grid,
+                                             CellId start, CellId goal) {
+    target = goal;
+    lineChecks = 0;
+    SearchWorkspace &ws = *workspace;
+    ws.prepare(grid.size());
+    open.reset(ws);
+    ws.cost.set(start, 0);
+    ws.parent.set(start, start);
+    open.push(start, 0);
+}
+
+// Lazy Theta*: replaces the assumed line of sight between a cell about to
+// be expanded and its parent with the real cost, or with the best expanded
+// neighbour if that is cheaper or the line is blocked.
+template <bool LAZY>
+void BasicThetaStarSolver<LAZY>::setVertex(const GridMap &grid,
+                                           CellId cell) {
+    SearchWorkspace &ws = *workspace;
+    CellId parent = ws.parent[cell];
+    if (parent == cell) return;
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    int best = INT_MAX;
+    // an adjacent parent is priced exactly by the neighbour scan below
+    if (std::abs(x - (int)grid.cellX(parent)) > 1 ||
+        std::abs(y - (int)grid.cellY(parent)) > 1) {
+        lineChecks++;
+        int line = lineCost(grid, parent, cell);
+        if (line >= 0)
+            best = ws.cost[parent] + distance(grid, parent, cell) * line;
+    }
+    CellId bestParent = parent;
+    forEachMove<AnyAngle>([&](const Move &move) {
+        // the neighbour that reaches `cell` with this move
+        int nx = x - move.dx;
+        int ny = y - move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!ws.closed.test(next)) return;
+        if (!AnyAngle::allowed(grid, nx, ny, move)) return;
+        int cost = ws.cost[next] + stepCost(grid, next, nx, ny, move);
+        // keep the parent on ties, for straighter paths
+        if (cost < best || (next == parent && cost == best)) {
+            best = cost;
+            bestParent = next;
+        }
+    });
+    ws.cost.set(cell, best);
+    ws.parent.set(cell, bestParent);
+}
+
+template <bool LAZY>
+CellId BasicThetaStarSolver<LAZY>::expandNext(const GridMap &grid) {
+    SearchWorkspace &ws = *workspace;
+    CellId cell;
+    while (true) {
+        if (open.empty()) return NO_CELL;
+        cell = open.pop().second;
+        if (ws.closed.test(cell)) continue;
+        if (!LAZY) break;
+        // a cell whose assumed cost was too low goes back to the queue
+        int assumed = ws.cost[cell];
+        setVertex(grid, cell);
+        if (ws.cost[cell] == assumed) break;
+        open.push(cell, ws.cost[cell] + calculateHeuristic(grid, cell));
+    }
+    ws.closed.set(cell);
+    if (cell == target) return cell;
+
+    int x = grid.cellX(cell);
+    int y = grid.cellY(cell);
+    CellId parent = ws.parent[cell];
+    forEachMove<AnyAngle>([&](const Move &move) {
+        int nx = x + move.dx;
+        int ny = y + move.dy;
+        if (nx < 0 || nx >= grid.n || ny < 0 || ny >= grid.m) return;
+        CellId next = grid.index(nx, ny);
+        if (!grid.passable[next]) return;
+        if (!AnyAngle::allowed(grid, x, y, move)) return;
+        if (ws.closed.test(next)) return;
+        int newCost = ws.cost[cell] + stepCost(grid, cell, x, y, move);
+        CellId newParent = cell;
+        if (parent != cell) {
+            // prefer the parent on ties, for straighter paths
+            int line = grid.cost(parent);
+            if (!LAZY) {
+                lineChecks++;
+                line = lineCost(grid, parent, next);
+            }
+            if (line >= 0) {
+                int viaParent =
+                    ws.cost[parent] + distance(grid, parent, next) * line;
+                if (viaParent <= newCost) {
+                    newCost = viaParent;
+                    newParent = parent;
+                }
+            }
+        }
+        if (newCost >= ws.cost[next]) return;
+        ws.cost.set(next, newCost);
+        ws.parent.set(next, newParent);
+        open.push(next, newCost + calculateHeuristic(grid, next));
+    });
+    return cell;
+}
+
+template class BasicThetaStarSolver<false>;
+template class BasicThetaStarSolver<true>;
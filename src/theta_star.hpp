@@ -0,0 +1,58 @@
+#ifndef THETA_STAR_HPP
+#define THETA_STAR_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "movement.hpp"
+#include "open_list.hpp"
+#include "solver.hpp"
+
+// Theta*: A* over the 8-connected grid where a cell may take its
+// grandparent as parent when the two are in line of sight, which gives
+// any-angle paths. The path holds only the turning points; consecutive
+// ones are joined by straight segments costing their length times the
+// highest terrain cost they cover (see lineCost).
+//
+// The lazy variant assumes line of sight when a cell is generated, with
+// the grandparent's terrain cost, and only checks it once the cell is
+// expanded, falling back to the best expanded neighbour. That needs at
+// most one check each time a cell leaves the queue instead of one per
+// generated neighbour, and none when the parent is adjacent. A cell whose
+// assumed cost turns out too low is put back in the queue with the real
+// cost instead of being expanded.
+template <bool LAZY>
+class BasicThetaStarSolver : public Solver {
+    QuaternaryHeap open;
+
+    int calculateHeuristic(const GridMap &grid, CellId cell) {
+        return AnyAngle::heuristic(
+            std::abs((int)grid.cellX(cell) - (int)grid.cellX(target)),
+            std::abs((int)grid.cellY(cell) - (int)grid.cellY(target)));
+    };
+    int distance(const GridMap &grid, CellId a, CellId b) {
+        return AnyAngle::distance(
+            (int)grid.cellX(a) - (int)grid.cellX(b),
+            (int)grid.cellY(a) - (int)grid.cellY(b));
+    }
+    void setVertex(const GridMap &grid, CellId cell);
+
+   protected:
+    void startSearch(const GridMap &grid, CellId start,
+                     CellId goal) override;
+    CellId expandNext(const GridMap &grid) override;
+
+   public:
+    // Line-of-sight checks made by the current query.
+    std::size_t lineChecks = 0;
+
+    BasicThetaStarSolver() { straightCost = AnyAngle::STRAIGHT; }
+    std::string getName() override {
+        return LAZY ? "Lazy Theta* Solver" : "Theta* Solver";
+    }
+};
+
+using ThetaStarSolver = BasicThetaStarSolver<false>;
+using LazyThetaStarSolver = BasicThetaStarSolver<true>;
+
+#endif
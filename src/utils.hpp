@@ -1,41 +1,15 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
-#include <glm/glm.hpp>
-
+// The value of a passable type is the cost of leaving a cell of that type.
+// WALL cells are impassable and pruned from the search, so its value is
+// never charged.
 enum class CellType { CLEAR = 1, WALL = 100000, FOREST = 5, WATER = 10 };
 
 enum class DrawMode { WALL, FOREST, WATER, PATH_START, PATH_GOAL };
 
-struct Cell {
-    unsigned int x, y;
-    bool visited = false;
-    CellType type = CellType::CLEAR;
-    Cell(unsigned int x_, unsigned int y_) : x(x_), y(y_) {};
-};
-
-constexpr glm::vec4 getCellColor(Cell& cell) {
-    glm::vec4 col;
-    switch (cell.type) {
-        case CellType::CLEAR:
-            col = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-            break;
-        case CellType::FOREST:
-            col = glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
-            break;
-        case CellType::WATER:
-            col = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
-            break;
-        case CellType::WALL:
-            col = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-            break;
-        default:
-            col = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-            break;
-    }
-    if (cell.visited)
-        col = glm::mix(col, glm::vec4(0.5f, 0.5f, 0.5f, 1.0f), 0.5f);
-    return col;
-};
+// Linear, row-major cell index: id = y * width + x.
+using CellId = unsigned int;
+constexpr CellId NO_CELL = ~0u;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,18 @@
+#include "workspace.hpp"
+
+#include <climits>
+
+void SearchWorkspace::prepare(std::size_t cells) {
+    cost.prepare(cells, INT_MAX);
+    parent.prepare(cells, NO_CELL);
+    closed.prepare(cells);
+    heapIndex.prepare(cells, ~0u);
+    open.clear();
+    pairOpen.clear();
+}
+
+std::shared_ptr<SearchWorkspace> SearchWorkspace::forThread() {
+    thread_local std::shared_ptr<SearchWorkspace> workspace =
+        std::make_shared<SearchWorkspace>();
+    return workspace;
+}
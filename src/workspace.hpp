@@ -0,0 +1,34 @@
+#ifndef WORKSPACE_HPP
+#define WORKSPACE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "epoch.hpp"
+#include "utils.hpp"
+
+// Search storage owned outside the solvers: g-costs, parents, the closed
+// set and the open list entries (see open_list.hpp). It is sized once per
+// map and only reset between queries, so repeated queries on the same map
+// perform no heap allocations once the open list buffers have grown to
+// fit them.
+struct SearchWorkspace {
+    EpochArray<int> cost;
+    EpochArray<CellId> parent;
+    EpochBitset closed;
+    std::vector<std::pair<int, CellId>> open;
+    std::vector<std::pair<std::pair<int, int>, CellId>> pairOpen;
+    EpochArray<unsigned int> heapIndex;
+    std::vector<std::vector<CellId>> buckets;
+
+    // Prepares the workspace for a new query on a map with `cells` cells.
+    void prepare(std::size_t cells);
+
+    // Workspace pooled per thread; solvers running on the same thread
+    // one after another can share it instead of keeping their own.
+    static std::shared_ptr<SearchWorkspace> forThread();
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+
+// Minimal assertions for the test executables: a failed CHECK prints its
+// location and makes checkResult() return 1, the exit status of the test.
+
+inline int &checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                              \
+    do {                                                              \
+        if (!(condition)) {                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, \
+                         __LINE__, #condition);                       \
+            checkFailures()++;                                        \
+        }                                                             \
+    } while (0)
+
+inline int checkResult() { return checkFailures() == 0 ? 0 : 1; }
+
+#endif
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ch_solver.hpp"
+#include "check.hpp"
+#include "grid_map.hpp"
+#include "solver.hpp"
+
+// A hierarchy saved and loaded back answers every query like the one it
+// was saved from, and files made for another map are refused.
+
+static GridMap randomMap(int size, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    GridMap grid(size, size);
+    const CellType types[] = {CellType::WALL, CellType::FOREST,
+                              CellType::WATER};
+    for (CellId cell = 0; cell < (CellId)grid.size(); cell++) {
+        if (rng() % 4 == 0) grid.setTerrain(cell, types[rng() % 3]);
+    }
+    return grid;
+}
+
+int main() {
+    const char *path = "contraction_hierarchy_test.ch";
+    std::remove(path);
+    GridMap built = randomMap(48, 1);
+    // nothing saved yet, so it is built and saved
+    CHECK(!built.buildHierarchy(path));
+    CHECK(built.hierarchy && built.hierarchy->matches(built));
+
+    GridMap loaded = randomMap(48, 1);
+    CHECK(loaded.buildHierarchy(path));
+    CHECK(loaded.hierarchy && loaded.hierarchy->matches(loaded));
+    if (!loaded.hierarchy) return checkResult();
+    CHECK(loaded.hierarchy->shortcuts() == built.hierarchy->shortcuts());
+
+    CHSolver fromBuilt, fromLoaded;
+    DijkstraSolver reference;
+    std::mt19937 rng(2);
+    for (int i = 0; i < 200; i++) {
+        CellId start = rng() % built.size();
+        CellId goal = rng() % built.size();
+        SearchResult a = fromBuilt.findPath(built, start, goal);
+        SearchResult b = fromLoaded.findPath(loaded, start, goal);
+        SearchResult r = reference.findPath(built, start, goal);
+        CHECK(a.found == r.found && b.found == r.found);
+        CHECK(a.cost == r.cost && b.cost == r.cost);
+        CHECK(a.path == b.path);
+    }
+
+    // same size, other terrain: the file and the hierarchy do not match
+    GridMap other = randomMap(48, 3);
+    std::string error;
+    CHECK(!ContractionHierarchy::load(path, other, error));
+    CHECK(!built.hierarchy->matches(other));
+    other.hierarchy = built.hierarchy;
+    SearchResult r = reference.findPath(other, 0, other.size() - 1);
+    SearchResult c = fromBuilt.findPath(other, 0, other.size() - 1);
+    CHECK(c.found == r.found && c.cost == r.cost);
+    // and the file is replaced by one for this map
+    other.hierarchy.reset();
+    CHECK(!other.buildHierarchy(path));
+    CHECK(ContractionHierarchy::load(path, other, error).has_value());
+    std::remove(path);
+    return checkResult();
+}
@@ -0,0 +1,62 @@
+#include <fstream>
+
+#include "check.hpp"
+#include "movingai.hpp"
+#include "scenario.hpp"
+#include "solver.hpp"
+
+// A hand-made map and scenario in the Moving AI formats, with octile lengths
+// worked out by hand: trees block, swamp is ordinary ground, diagonals do
+// not cut corners.
+
+static const char *MAP =
+    "type octile\n"
+    "height 5\n"
+    "width 5\n"
+    "map\n"
+    ".....\n"
+    ".TT@.\n"
+    "..S..\n"
+    ".....\n"
+    ".W...\n";
+
+static const char *SCEN =
+    "version 1\n"
+    "0\tscenario_test.map\t5\t5\t0\t0\t4\t0\t4.00000000\n"
+    // straight through the swamp
+    "0\tscenario_test.map\t5\t5\t0\t2\t4\t2\t4.00000000\n"
+    // around the tree at (1, 1), whose corners cannot be cut
+    "1\tscenario_test.map\t5\t5\t1\t0\t1\t2\t4.00000000\n"
+    // 2 + sqrt(2) + 3
+    "1\tscenario_test.map\t5\t5\t0\t0\t4\t3\t6.41421356\n"
+    // starts on water
+    "1\tscenario_test.map\t5\t5\t1\t4\t4\t4\t3.00000000\n";
+
+int main() {
+    std::ofstream("scenario_test.map") << MAP;
+    std::ofstream("scenario_test.map.scen") << SCEN;
+    std::string error;
+    auto grid = loadMovingAIMap("scenario_test.map", error);
+    auto entries = loadMovingAIScenario("scenario_test.map.scen", error);
+    CHECK(grid && entries);
+    if (!grid || !entries) return checkResult();
+    CHECK(grid->type(grid->index(1, 1)) == CellType::WALL);
+    CHECK(grid->type(grid->index(2, 2)) == CellType::CLEAR);
+    CHECK(grid->type(grid->index(1, 4)) == CellType::WALL);
+
+    BasicDijkstraSolver<BucketQueue, EightConnected> dijkstra;
+    BasicAStarSolver<QuaternaryHeap, EightConnected> astar;
+    for (Solver *solver : {(Solver *)&dijkstra, (Solver *)&astar}) {
+        ScenarioReport report = runScenario(*solver, *grid, *entries);
+        CHECK(report.queries == 4);
+        CHECK(report.skipped == 1);
+        CHECK(report.failed == 0);
+        CHECK(report.mismatched == 0);
+        CHECK(report.buckets.size() == 2);
+    }
+
+    // 4-connected paths are longer than the octile lengths
+    DijkstraSolver orthogonal;
+    CHECK(runScenario(orthogonal, *grid, *entries).mismatched == 1);
+    return checkResult();
+}
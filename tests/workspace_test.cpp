@@ -0,0 +1,104 @@
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+#include "grid_map.hpp"
+#include "solver.hpp"
+
+// Repeated queries on the same map must not allocate once the workspace
+// buffers have grown to fit them. Every heap allocation of the process is
+// counted by replacing the global operator new.
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// Runs queries through the search hooks, writing paths into a buffer the
+// caller reuses, so the result does not allocate either.
+template <typename S>
+struct Probe : S {
+    bool query(const GridMap &grid, CellId start, CellId goal,
+               std::vector<CellId> &path) {
+        this->startSearch(grid, start, goal);
+        CellId cell;
+        do {
+            cell = this->expandNext(grid);
+            if (cell == NO_CELL) return false;
+        } while (!this->pathFound(cell));
+        this->buildPath(grid, start, goal, path);
+        return true;
+    }
+};
+
+static GridMap randomMap(int size, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    GridMap grid(size, size);
+    const CellType types[] = {CellType::WALL, CellType::FOREST,
+                              CellType::WATER};
+    for (CellId cell = 0; cell < (CellId)grid.size(); cell++) {
+        if (rng() % 4 == 0) grid.setTerrain(cell, types[rng() % 3]);
+    }
+    return grid;
+}
+
+static std::vector<std::pair<CellId, CellId>> randomQueries(
+    const GridMap &grid, int count, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::pair<CellId, CellId>> queries;
+    while ((int)queries.size() < count) {
+        CellId start = rng() % grid.size();
+        CellId goal = rng() % grid.size();
+        if (grid.passable[start] && grid.passable[goal])
+            queries.push_back({start, goal});
+    }
+    return queries;
+}
+
+template <typename S>
+static void checkSolver(const GridMap &grid) {
+    auto queries = randomQueries(grid, 50, 7);
+    Probe<S> solver;
+    std::vector<CellId> path;
+    std::size_t before = allocations;
+    solver.query(grid, queries[0].first, queries[0].second, path);
+    // the first query sizes the buffers
+    CHECK(allocations > before);
+
+    // two passes: the bucket queue may re-lay its buckets in the first
+    for (int pass = 0; pass < 2; pass++) {
+        for (auto [start, goal] : queries)
+            solver.query(grid, start, goal, path);
+    }
+    std::size_t warm = allocations;
+    for (auto [start, goal] : queries) solver.query(grid, start, goal, path);
+    CHECK(allocations == warm);
+
+    // a larger map needs new buffers
+    GridMap other = randomMap(192, 3);
+    auto otherQueries = randomQueries(other, 1, 5);
+    std::size_t small = allocations;
+    solver.query(other, otherQueries[0].first, otherQueries[0].second, path);
+    CHECK(allocations > small);
+}
+
+int main() {
+    GridMap grid = randomMap(128, 1);
+    checkSolver<DijkstraSolver>(grid);
+    checkSolver<BasicDijkstraSolver<QuaternaryHeap>>(grid);
+    checkSolver<BasicDijkstraSolver<LazyBinaryHeap>>(grid);
+    checkSolver<AStarSolver>(grid);
+    checkSolver<BasicAStarSolver<BinaryHeap>>(grid);
+    checkSolver<BasicAStarSolver<BucketQueue>>(grid);
+    checkSolver<BasicAStarSolver<QuaternaryHeap, EightConnected>>(grid);
+    return checkResult();
+}